@@ -0,0 +1,38 @@
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Fixed size bit set, used for truth tables over all 2^literals minterms.
+ */
+class Bitmap {
+    public:
+        Bitmap();
+
+        Bitmap(size_t size);
+
+        virtual ~Bitmap();
+
+        size_t size() const;
+
+        bool test(size_t i) const;
+
+        void set(size_t i);
+
+        void reset(size_t i);
+
+        size_t count() const;
+
+        std::vector<uint64_t>& getWords();
+
+        const std::vector<uint64_t>& getWords() const;
+
+    private:
+        std::vector<uint64_t> _words;
+        size_t _size;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "../include/term.h"
+#include "../include/cover.h"
+
+#include <queue>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * On-disk state of a tabular minimization, so that a run that is killed can
+ * be continued with --resume. combine_terms() saves its queue (the rest of
+ * the current level and the next level so far), the group it is merging and
+ * the primes so far every interval; the primes are saved once the combine
+ * phase is over, again with the best cover so far every time the cover
+ * search improves it (so a search that is killed resumes bounded by that
+ * cover), and the cover once it is chosen. Every save goes to a
+ * temporary file that is renamed over DIR/checkpoint.qmc, so the file is
+ * always the last consistent checkpoint.
+ *
+ * The format is a header (magic, version, literals count, phase and a
+ * fingerprint of the ON/Dont-Care minterms, so a checkpoint is never
+ * resumed for another function) followed by sections of 9 byte implicant
+ * records: value, dash mask and flags (Dont-Care, selected, level
+ * separator, in the best cover).
+ */
+class Checkpoint {
+    public:
+        enum Phase {
+            EMPTY,
+            COMBINE,
+            PRIMES,
+            COVER,
+            SEARCH
+        };
+
+        // creates directory if needed; throws std::runtime_error if it cannot
+        Checkpoint(const std::string& directory, double interval_ms, bool resume);
+
+        virtual ~Checkpoint();
+
+        /**
+         * Ties the checkpoint to the function being minimized and, when
+         * resuming, loads the last checkpoint written for it. Throws
+         * std::runtime_error if that checkpoint is unreadable or was written
+         * for another function.
+         */
+        void open(const std::vector<unsigned int>& onValues,
+                  const std::vector<unsigned int>& dontCareValues, size_t literals_count);
+
+        Phase getPhase() const;
+
+        bool isDue() const;
+
+        void saveCombine(std::queue<Term*> termsQueue, const Terms& currentTerms, const Terms& primeTerms);
+
+        void savePrimes(const Terms& primeTerms);
+
+        void saveCover(const Terms& cover, const CoverResult& coverResult, bool searched);
+
+        // the primes, marking the ones of cover, the best cover found so far
+        void saveSearch(const Terms& primeTerms, const Terms& cover);
+
+        // the restored implicants are new Terms, appended to terms (which owns them)
+        void restoreCombine(std::queue<Term*>& termsQueue, Terms& currentTerms, Terms& primeTerms,
+                            Terms& terms) const;
+
+        // also restores the primes of a SEARCH checkpoint
+        void restorePrimes(Terms& primeTerms, Terms& terms) const;
+
+        /**
+         * The best cover of a SEARCH checkpoint, out of the primeTerms that
+         * restorePrimes() restored (in its order).
+         */
+        void restoreSearch(const Terms& primeTerms, Terms& cover) const;
+
+        void restoreCover(Terms& cover, CoverResult& coverResult, bool& searched, Terms& terms) const;
+
+    private:
+        struct Record {
+            Record() :
+                value(0),
+                dash_mask(0),
+                flags(0)
+            {
+            }
+
+            uint32_t value;
+            uint32_t dash_mask;
+            uint8_t flags;
+        };
+
+        typedef std::vector<Record> Records;
+
+        static void toRecords(const Terms& terms, Records& records);
+
+        Term* toTerm(const Record& record) const;
+
+        void restore(const Records& records, Terms& restored, Terms& terms) const;
+
+        void load();
+
+        void save(Phase phase, const std::vector<const Records*>& sections);
+
+        std::string _directory;
+        double _interval_ms;
+        bool _resume;
+        double _saved_at;
+        size_t _literals_count;
+        uint64_t _fingerprint;
+        Phase _phase;
+        std::vector<Records> _sections;
+        CoverResult _cover_result;
+        bool _searched;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef CODE_EMITTER_H
+#define CODE_EMITTER_H
+
+#include "../include/cube_input.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Code generation for a final cover. Every emitter writes a function (or
+ * module) called name taking the literals as one unsigned input, variable
+ * 'a' being its most significant bit, with comment (e.g. the "f = ..."
+ * form) on top. With inverted, cover is the OFF-set cover of a product of
+ * sums and the emitted code returns its negation.
+ */
+
+// branchless C/C++: one mask/compare per product, ORed together
+void emit_c(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+            const std::string& name, const std::string& comment, bool inverted);
+
+// C/C++ truth table lookup, for up to EMIT_TABLE_MAX_LITERALS literals
+const size_t EMIT_TABLE_MAX_LITERALS = 16;
+
+void emit_table(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+                const std::string& name, const std::string& comment, bool inverted);
+
+// Verilog module with a single continuous assign
+void emit_verilog(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+                  const std::string& name, const std::string& comment, bool inverted);
+
+#endif
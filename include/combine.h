@@ -0,0 +1,38 @@
+#ifndef COMBINE_H
+#define COMBINE_H
+
+#include "../include/term.h"
+#include "../include/checkpoint.h"
+
+/**
+ * Tabular Quine-McCluskey combine phase. Sorts the minterm terms, merges
+ * adjacent groups level by level and appends every new implicant to terms
+ * (which owns them). Implicants that were never merged are appended to
+ * primeTerms. With a checkpoint, the state between two groups is saved
+ * whenever it is due, and a checkpoint loaded in the COMBINE phase is
+ * continued instead of starting from the minterms.
+ */
+void combine_terms(Terms& terms, Terms& primeTerms, Checkpoint* checkpoint = 0);
+
+/**
+ * Combine phase that only builds implicants holding an ON minterm. A merge
+ * partner that covers Dont-Cares only is never stored, but looked up (and
+ * memoized) against the Dont-Care minterms, so Dont-Care-only lineages cost
+ * nothing past the partners actually asked for. Takes and returns the same
+ * as combine_terms(); the primes are cubes whose minterms are enumerated
+ * lazily.
+ */
+void combine_on_terms(Terms& terms, Terms& primeTerms);
+
+/**
+ * Combine phase for cube input: terms may hold cubes (Term's cube
+ * constructor) as well as minterms, each entering the table at the level of
+ * its dash count. Same-dash pairs one bit apart are merged level by level as
+ * in combine_terms(), then the cubes never merged are closed under
+ * consensus_terms(), since cubes of different dash masks (a'b + ac) can
+ * still hide primes (bc) that merging alone does not reach. Takes and
+ * returns the same as combine_terms().
+ */
+void combine_cube_terms(Terms& terms, Terms& primeTerms);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef CONSENSUS_H
+#define CONSENSUS_H
+
+#include "../include/term.h"
+
+/**
+ * Iterated consensus prime generation, working directly on cubes. terms
+ * holds the ON cubes and the Dont-Care cubes (flagged with dontCare()); the
+ * consensus of every pair of cubes at distance one is added unless an
+ * existing cube contains it, and cubes it contains are absorbed. New cubes
+ * are appended to terms (which owns them). At the fixed point the surviving
+ * cubes are exactly the primes; those touching the ON-set are appended to
+ * primeTerms.
+ */
+void consensus_terms(Terms& terms, Terms& primeTerms);
+
+#endif
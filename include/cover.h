@@ -0,0 +1,114 @@
+#ifndef COVER_H
+#define COVER_H
+
+#include "../include/term.h"
+#include "../include/deadline.h"
+
+#include <vector>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+
+class Checkpoint;
+
+/**
+ * Prime implicant chart: one row per minterm that has to be covered (every
+ * minterm of a prime that is not a Dont-Care) and one column per prime.
+ * Given the ON minterms instead, those are the rows, and a prime is matched
+ * against them rather than enumerated (its Dont-Cares may be countless).
+ */
+class CoverChart {
+    public:
+        CoverChart(const Terms& dontCareTerms);
+
+        CoverChart(const std::vector<unsigned int>& onValues);
+
+        virtual ~CoverChart();
+
+        void addPrime(Term* term);
+
+        size_t getRowsCount() const;
+
+        size_t getColumnsCount() const;
+
+        const std::vector<size_t>& getRow(size_t row) const;
+
+        const std::vector<size_t>& getColumn(size_t column) const;
+
+        Term* getPrime(size_t column) const;
+
+        int getColumnIndex(const Term* term) const;
+
+    private:
+        Terms _primes;
+        std::vector<std::vector<size_t> > _rows;
+        std::vector<std::vector<size_t> > _columns;
+        std::tr1::unordered_map<size_t, size_t> _row_indices;
+        std::tr1::unordered_map<const Term*, size_t> _column_indices;
+        std::tr1::unordered_set<size_t> _dont_cares;
+        std::vector<unsigned int> _on_values;
+        bool _on_rows;
+};
+
+struct CoverResult {
+    CoverResult() :
+        cover(),
+        cost(0),
+        lower_bound(0),
+        optimal(false)
+    {
+    }
+
+    Terms cover;
+    size_t cost;
+    size_t lower_bound;
+    bool optimal;
+};
+
+/**
+ * Cover phase: picks the essential prime implicants and then, while
+ * minterms remain uncovered, the prime covering the most of them.
+ * Minterms of dontCareTerms (minterms or cubes) never need to be covered.
+ */
+Terms select_cover(Terms& primeTerms, const Terms& dontCareTerms);
+
+/**
+ * Anytime cover phase. Starts from the select_cover() greedy cover and
+ * improves it with a branch and bound search over the prime chart until the
+ * cover is proven optimal or the deadline expires. The cost is the number of
+ * products, and lower_bound is a bound on the optimal cost (equal to cost
+ * when optimal is set). With a checkpoint, every better cover the search
+ * finds is saved, and the cover of a SEARCH checkpoint being resumed
+ * replaces the greedy one as the start (and bound) when it is smaller.
+ */
+CoverResult search_cover(Terms& primeTerms, const Terms& dontCareTerms, const Deadline& deadline,
+                         Checkpoint* checkpoint = 0);
+
+/**
+ * Greedy cover straight on a chart: the essential primes, then while rows
+ * remain uncovered the prime covering the most of them.
+ */
+Terms chart_cover(const CoverChart& chart);
+
+/**
+ * Branch and bound over a chart, starting from the seed cover (which must
+ * cover every row). See search_cover().
+ */
+CoverResult search_chart_cover(const CoverChart& chart, const Terms& seed, const Deadline& deadline,
+                               Checkpoint* checkpoint = 0);
+
+/**
+ * Portfolio cover search: threads_count workers attack the chart at once,
+ * alternating branch and bound searches (each breaking ties between columns
+ * differently) and local searches, all bounded by the best cover any of
+ * them has found. Returns once a branch and bound completes, proving that
+ * cover optimal, or the deadline expires. With one thread it is
+ * search_chart_cover().
+ */
+CoverResult portfolio_chart_cover(const CoverChart& chart, const Terms& seed, const Deadline& deadline,
+                                  size_t threads_count, Checkpoint* checkpoint = 0);
+
+// search_cover() as a portfolio; see portfolio_chart_cover()
+CoverResult portfolio_cover(Terms& primeTerms, const Terms& dontCareTerms, const Deadline& deadline,
+                            size_t threads_count, Checkpoint* checkpoint = 0);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef COVER_EVALUATOR_H
+#define COVER_EVALUATOR_H
+
+#include "../include/bitmap.h"
+#include "../include/cube_input.h"
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Bit-sliced evaluator for a cover (a sum of cubes). Inputs are processed
+ * SLICE_BITS at a time: plane i holds variable i of every input, one input
+ * per bit, and a cube is the AND of its literal planes, so each vector
+ * operation evaluates one product for 256 inputs (a single instruction with
+ * AVX2, e.g. -march=native; two SSE2 ones otherwise). Slices are passed by
+ * reference, so the ABI does not depend on the instruction set.
+ *
+ * Variable i is bit i of an input (literal 'a' being the most significant
+ * of literals_count bits), as for Term and Cube values.
+ */
+class CoverEvaluator {
+    public:
+        typedef uint64_t Slice __attribute__((vector_size(32)));
+
+        static const size_t SLICE_BITS = 256;
+
+        CoverEvaluator(const std::vector<Cube>& cover, size_t literals_count);
+
+        virtual ~CoverEvaluator();
+
+        size_t getLiteralsCount() const;
+
+        bool evaluate(unsigned int input) const;
+
+        // planes[i] holds variable i of SLICE_BITS inputs
+        void evaluate(const Slice* planes, Slice& result) const;
+
+        // evaluates the inputs block * SLICE_BITS .. (block + 1) * SLICE_BITS - 1
+        void evaluateBlock(size_t block, Slice& result) const;
+
+        /**
+         * Checks the cover against every input: it must be 1 on the ON-set
+         * and 0 off the ON and Dont-Care sets. On a mismatch returns false
+         * and sets counterexample to the smallest offending input.
+         */
+        bool verify(const Bitmap& on_set, const Bitmap& dont_care_set, unsigned int& counterexample) const;
+
+    private:
+        void fillPlanes(size_t block, std::vector<Slice>& planes) const;
+
+        struct Literal {
+            Literal(size_t literal_variable, bool literal_positive) :
+                variable(literal_variable),
+                positive(literal_positive)
+            {
+            }
+
+            size_t variable;
+            bool positive;
+        };
+
+        std::vector<Cube> _cover;
+        std::vector<Literal> _literals;
+        std::vector<size_t> _cube_ends;
+        size_t _literals_count;
+};
+
+#endif
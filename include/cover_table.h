@@ -0,0 +1,21 @@
+#ifndef COVER_TABLE_H
+#define COVER_TABLE_H
+
+#include "../include/term.h"
+
+#include <vector>
+
+/**
+ * Minimal covers of every function of up to COVER_TABLE_MAX_LITERALS
+ * literals, generated at build time (src/cover_table_generator.cpp). A
+ * cover has the fewest products, then the fewest literals. Functions with
+ * Dont-Cares are served by the cheapest table entry over every completion
+ * of the Dont-Care set. Only the cover's cubes become Terms.
+ */
+const size_t COVER_TABLE_MAX_LITERALS = 4;
+
+Terms table_cover(const std::vector<unsigned int>& onValues,
+                  const std::vector<unsigned int>& dontCareValues,
+                  size_t literals_count);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CUBE_INPUT_H
+#define CUBE_INPUT_H
+
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * A cube as (value, dash mask): bits set in the dash mask are '-', the
+ * remaining bits of value hold the fixed literals. The leftmost character
+ * of a cube string ("1-0-") is literal 'a', the most significant bit.
+ */
+typedef std::pair<unsigned int, unsigned int> Cube;
+
+bool parse_cube(const std::string& text, Cube& cube);
+
+/**
+ * Reads a single output Berkeley PLA file. Cubes whose output is '1' are
+ * added to onCubes, '-' (or '2') to dontCareCubes and '0' cubes are
+ * ignored. literals_count is taken from .i (or from the first cube).
+ * Throws std::runtime_error on malformed input.
+ */
+void read_pla(std::istream& input,
+              size_t& literals_count,
+              std::vector<Cube>& onCubes,
+              std::vector<Cube>& dontCareCubes);
+
+/**
+ * The literals count an expression needs: its highest letter ('a' is the
+ * first literal) plus one, 0 if it has no letters.
+ */
+size_t expression_literals_count(const std::string& text);
+
+/**
+ * Parses a Boolean expression over literals_count literals straight into a
+ * cover, appended to cubes: letters are literals ('a' first), a product is
+ * a juxtaposition, '+' is a sum, a postfix ' complements a letter or a
+ * parenthesized expression, and 0/1 are the constants. Products distribute
+ * cube by cube, never through minterms, and cubes contained in another are
+ * dropped. Throws std::runtime_error on malformed input.
+ */
+void parse_expression(const std::string& text, size_t literals_count, std::vector<Cube>& cubes);
+
+/**
+ * Appends every minterm of the cubes to values.
+ */
+void expand_cubes(const std::vector<Cube>& cubes, std::vector<unsigned int>& values);
+
+#endif
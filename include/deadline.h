@@ -0,0 +1,29 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+/**
+ * Wall clock deadline measured from construction. A budget of 0 never
+ * expires.
+ */
+class Deadline {
+    public:
+        Deadline(double budget_ms = 0);
+
+        virtual ~Deadline();
+
+        bool isSet() const;
+
+        bool expired() const;
+
+        double elapsed() const;
+
+        double remaining() const;
+
+        static double now();
+
+    private:
+        double _start;
+        double _budget_ms;
+};
+
+#endif
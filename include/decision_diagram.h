@@ -0,0 +1,149 @@
+#ifndef DECISION_DIAGRAM_H
+#define DECISION_DIAGRAM_H
+
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <tr1/unordered_map>
+#include <stdint.h>
+
+/**
+ * Small BDD/ZDD package for implicit prime generation.
+ *
+ * BDDs represent Boolean functions over variables_count variables, variable
+ * 0 being literal 'a' (the most significant minterm bit). ZDDs represent
+ * sets of cubes over 2 * variables_count literals: ZDD variable 2i is the
+ * positive literal of variable i and 2i + 1 its complement.
+ *
+ * Node 0 is the FALSE function / empty set, node 1 the TRUE function / the
+ * set holding only the empty cube.
+ *
+ * ADDs (BDDs with numbers on the terminals) count minterms while a best
+ * cube is searched. They are kept (up to a limit) for the next search,
+ * which reuses what its function shares with the earlier ones.
+ *
+ * Every node is charged to the MemoryBudget, so --max-memory holds for the
+ * diagrams as it does for implicants (MemoryBudgetExceeded is thrown).
+ */
+class DecisionDiagram {
+    public:
+        typedef unsigned int Node;
+
+        static const Node ZERO = 0;
+        static const Node ONE = 1;
+
+        DecisionDiagram(size_t variables_count);
+
+        virtual ~DecisionDiagram();
+
+        Node bddFromMinterms(const std::vector<unsigned int>& minterms);
+
+        Node bddAnd(Node left, Node right);
+
+        // function without the minterms of the cube (value, dash mask)
+        Node bddWithoutCube(Node function, unsigned int value, unsigned int dash_mask);
+
+        bool bddContains(Node function, unsigned int minterm);
+
+        Node zddNode(size_t variable, Node low, Node high);
+
+        Node zddUnion(Node left, Node right);
+
+        Node zddDifference(Node left, Node right);
+
+        Node zddContaining(Node cubes, unsigned int minterm);
+
+        double zddCount(Node cubes);
+
+        void zddCubes(Node cubes, std::vector<std::pair<unsigned int, unsigned int> >& output);
+
+        Node primes(Node function);
+
+        /**
+         * The cube of cubes holding the most minterms of function, found on
+         * the diagrams without listing the cubes. Returns that number of
+         * minterms, or -1 (and leaves cube alone) if cubes is empty.
+         */
+        double zddBestCube(Node cubes, Node function, std::pair<unsigned int, unsigned int>& cube);
+
+        size_t getBddNodesCount() const;
+
+        size_t getZddNodesCount() const;
+
+    private:
+        struct DiagramNode {
+            DiagramNode(unsigned int node_variable, Node node_low, Node node_high) :
+                variable(node_variable),
+                low(node_low),
+                high(node_high)
+            {
+            }
+
+            unsigned int variable;
+            Node low;
+            Node high;
+        };
+
+        struct NodeKeyHash {
+            size_t operator()(const std::pair<unsigned int, uint64_t>& key) const {
+                return key.second * 0x9e3779b97f4a7c15ULL + key.first;
+            }
+        };
+
+        typedef std::tr1::unordered_map<std::pair<unsigned int, uint64_t>, Node, NodeKeyHash> UniqueTable;
+        typedef std::tr1::unordered_map<uint64_t, Node> OperationCache;
+
+        static uint64_t key(Node left, Node right);
+
+        void charge();
+
+        Node bddNode(size_t variable, Node low, Node high);
+
+        Node bddFromMinterms(const std::vector<unsigned int>& minterms,
+                             size_t begin, size_t end, size_t variable);
+
+        Node bddWithoutCube(Node function, size_t variable, unsigned int value, unsigned int dash_mask,
+                            OperationCache& cache);
+
+        Node addTerminal(double value);
+
+        Node addNode(size_t variable, Node low, Node high);
+
+        Node addFromBdd(Node function);
+
+        Node addPlus(Node left, Node right);
+
+        double addTotal(Node add, size_t variable);
+
+        unsigned int gainTop(Node cubes, Node add) const;
+
+        double zddGain(Node cubes, Node add, size_t variable);
+
+        Node zddContaining(Node cubes, unsigned int minterm, OperationCache& cache);
+
+        double zddCount(Node cubes, std::tr1::unordered_map<Node, double>& cache);
+
+        void zddCubes(Node cubes, unsigned int value, unsigned int care,
+                      std::vector<std::pair<unsigned int, unsigned int> >& output);
+
+        size_t _variables_count;
+        std::vector<DiagramNode> _bdd;
+        std::vector<DiagramNode> _zdd;
+        UniqueTable _bdd_unique;
+        UniqueTable _zdd_unique;
+        OperationCache _and_cache;
+        OperationCache _union_cache;
+        OperationCache _difference_cache;
+        std::tr1::unordered_map<Node, Node> _primes_cache;
+        std::vector<DiagramNode> _add;
+        std::vector<double> _add_values;
+        UniqueTable _add_unique;
+        std::tr1::unordered_map<double, Node> _add_terminals;
+        std::tr1::unordered_map<Node, Node> _add_cache;
+        OperationCache _plus_cache;
+        std::tr1::unordered_map<Node, double> _total_cache;
+        std::tr1::unordered_map<uint64_t, double> _gain_cache;
+        size_t _charged_bytes;
+};
+
+#endif
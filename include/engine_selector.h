@@ -0,0 +1,70 @@
+#ifndef ENGINE_SELECTOR_H
+#define ENGINE_SELECTOR_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * What --engine auto looks at before committing to an engine: the ON and
+ * Dont-Care densities and the number of implicants per level (number of
+ * dashes). Level 0 is exact; the others are extrapolated from subcubes
+ * around sampled ON/Dont-Care minterms: the fraction of the cubes over the
+ * subcube's variables that are implicants, scaled to all variables.
+ */
+class FunctionStats {
+    public:
+        FunctionStats(const std::vector<unsigned int>& onValues,
+                      const std::vector<unsigned int>& dontCareValues,
+                      size_t cubes_count, size_t literals_count);
+
+        virtual ~FunctionStats();
+
+        size_t getLiteralsCount() const;
+
+        size_t getCubesCount() const;
+
+        double getOnDensity() const;
+
+        double getDontCareDensity() const;
+
+        const std::vector<double>& getLevelImplicants() const;
+
+        double getImplicants() const;
+
+        void print(std::ostream& output) const;
+
+    private:
+        void sample(const std::vector<unsigned int>& care);
+
+        size_t _literals_count;
+        size_t _cubes_count;
+        double _on_density;
+        double _dont_care_density;
+        std::vector<double> _level_implicants;
+        double _implicants;
+};
+
+/**
+ * Up to this many estimated implicants, the primes are generated
+ * explicitly and the cover is searched for exactly (for at most
+ * AUTO_SEARCH_MS); past it, the ZDD engine keeps them implicit.
+ */
+const double AUTO_EXACT_IMPLICANTS = 1000;
+
+const double AUTO_SEARCH_MS = 1000;
+
+/**
+ * The engine for a function with these statistics: cube input stays in
+ * cubes (consensus), small functions come from the cover table (tabular),
+ * few implicants go to a bitmap engine (ternary, then shannon) with an
+ * exact cover search, many to zdd. A function whose implicants would not
+ * fit implicants_limit (0 for none) goes to zdd, whose diagrams the
+ * budget charges node by node, or straight to the heuristic when the
+ * budget falls back to it anyway.
+ */
+std::string select_engine(const FunctionStats& stats, size_t implicants_limit, bool heuristic_fallback,
+                          bool& exact_cover);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef EXTERNAL_COMBINE_H
+#define EXTERNAL_COMBINE_H
+
+#include "../include/term.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Implicants of the next level buffered in memory before they are sorted
+ * and spilled as runs, and the most runs merged at once (more are merged in
+ * passes first).
+ */
+const size_t SPILL_BUFFER_RECORDS = (size_t)1 << 20;
+
+const size_t SPILL_MERGE_RUNS = 64;
+
+/**
+ * Out-of-core combine phase. Each level lives in directory as sorted runs,
+ * one dash mask per run, sorted by the number of ones and then the value,
+ * so that the groups of a dash mask stream in one after the other. A level
+ * is combined mask by mask: the mask's runs are merged with sequential
+ * reads, and only the two adjacent groups being compared are resident. A
+ * cube is generated along its lowest dash only, so no level holds
+ * duplicates. Only the primes (ON ones) become Terms, appended to terms
+ * (which owns them) and primeTerms. Throws std::runtime_error if directory
+ * cannot be written; the spilled runs are removed either way.
+ */
+void combine_external_terms(const std::vector<unsigned int>& onValues,
+                            const std::vector<unsigned int>& dontCareValues,
+                            size_t literals_count, const std::string& directory,
+                            Terms& terms, Terms& primeTerms);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HEURISTIC_H
+#define HEURISTIC_H
+
+#include "../include/bitmap.h"
+#include "../include/term.h"
+
+/**
+ * Bounded memory fallback: walks the ON-set and greedily expands every
+ * uncovered minterm into a prime implicant against the ON/Dont-Care
+ * bitmaps. The result is a valid cover made of prime implicants, but
+ * it is not guaranteed to be minimal. Memory is two bitmaps plus the cover.
+ */
+Terms expand_cover(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include <atomic>
+#include <new>
+#include <string>
+
+/**
+ * Thrown by MemoryBudget when an allocation would exceed the configured
+ * limits. It is a std::bad_alloc, so callers can handle a real out of
+ * memory condition and a budget violation the same way.
+ */
+class MemoryBudgetExceeded : public std::bad_alloc {
+    public:
+        MemoryBudgetExceeded(const std::string& message);
+
+        virtual ~MemoryBudgetExceeded() throw();
+
+        virtual const char* what() const throw();
+
+    private:
+        std::string _message;
+};
+
+/**
+ * Process wide accounting of the memory held by implicants. Term's
+ * allocator charges every implicant here, and the budget refuses charges
+ * past --max-memory / --max-implicants. A limit of 0 means unlimited. The
+ * counters are atomic, so implicants may be created from several threads.
+ */
+class MemoryBudget {
+    public:
+        static MemoryBudget& instance();
+
+        void setMaxBytes(size_t max_bytes);
+
+        void setMaxImplicants(size_t max_implicants);
+
+        void disable();
+
+        void allocate(size_t bytes);
+
+        void release(size_t bytes);
+
+        void addImplicant();
+
+        void removeImplicant();
+
+        size_t getUsedBytes() const;
+
+        size_t getPeakBytes() const;
+
+        size_t getImplicants() const;
+
+        // implicants of implicant_bytes each the limits allow (0 = unlimited)
+        size_t getImplicantsLimit(size_t implicant_bytes) const;
+
+        static size_t parseBytes(const std::string& value);
+
+    private:
+        MemoryBudget();
+
+        MemoryBudget(const MemoryBudget&);
+
+        MemoryBudget& operator=(const MemoryBudget&);
+
+        size_t _max_bytes;
+        size_t _max_implicants;
+        std::atomic<size_t> _used_bytes;
+        std::atomic<size_t> _peak_bytes;
+        std::atomic<size_t> _implicants;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef MINIMIZER_H
+#define MINIMIZER_H
+
+#include "../include/cube_input.h"
+
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Incremental minimization session for a function edited a few minterms
+ * at a time. It keeps every implicant of the ON and Dont-Care sets, the
+ * primes among them and a prime cover, and each edit only touches the
+ * cubes holding the edited minterm:
+ *
+ * - a minterm entering the care set adds the implicants it completes (a
+ *   cube holding it is an implicant iff its half without it already was),
+ *   and the halves those absorb stop being primes;
+ * - a minterm leaving it drops the implicants holding it, and their other
+ *   halves may become primes again;
+ * - cover products that stopped being primes are expanded to one, those
+ *   that died are dropped and the ON minterms left uncovered are covered
+ *   again greedily (most uncovered ON minterms first), dropping products
+ *   made redundant by the new ones.
+ *
+ * The cover is irredundant and made of primes, but it is not guaranteed to
+ * be minimal: edits are repaired locally rather than re-solved.
+ */
+class Minimizer {
+    public:
+        Minimizer(size_t literals_count);
+
+        // starts from a whole function, covered in one pass
+        Minimizer(size_t literals_count,
+                  const std::vector<unsigned int>& onValues,
+                  const std::vector<unsigned int>& dontCareValues);
+
+        virtual ~Minimizer();
+
+        size_t getLiteralsCount() const;
+
+        // minterm becomes part of the ON-set
+        void addMinterm(unsigned int minterm);
+
+        // minterm becomes part of the OFF-set (neither ON nor Dont-Care)
+        void removeMinterm(unsigned int minterm);
+
+        // minterm becomes a Dont-Care
+        void setDontCare(unsigned int minterm);
+
+        std::vector<Cube> getCover() const;
+
+        size_t getImplicantsCount() const;
+
+        size_t getPrimesCount() const;
+
+    private:
+        typedef std::tr1::unordered_set<uint64_t> CubeSet;
+
+        bool isImplicant(unsigned int value, unsigned int dash_mask) const;
+
+        bool isPrime(unsigned int value, unsigned int dash_mask) const;
+
+        void implicantsHolding(unsigned int minterm, std::vector<uint64_t>& holding) const;
+
+        void addCare(unsigned int minterm);
+
+        void removeCare(unsigned int minterm);
+
+        void setOn(unsigned int minterm, bool on);
+
+        void updatePrime(uint64_t key);
+
+        uint64_t expand(uint64_t key) const;
+
+        void addToCover(uint64_t key);
+
+        void removeFromCover(uint64_t key);
+
+        void coverUncovered();
+
+        void dropRedundant(uint64_t key);
+
+        size_t _literals_count;
+        unsigned int _all;
+        std::tr1::unordered_set<unsigned int> _care;
+        std::tr1::unordered_set<unsigned int> _on;
+        CubeSet _implicants;
+        CubeSet _primes;
+        CubeSet _cover;
+        // number of cover products holding each ON minterm
+        std::tr1::unordered_map<unsigned int, size_t> _cover_counts;
+        std::vector<unsigned int> _uncovered;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MINTERM_INPUT_H
+#define MINTERM_INPUT_H
+
+#include "../include/bitmap.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * Hand-written minterm parser for --sop/--pos/--dont-care/--off tokens and
+ * --input files. A token is a minterm ("12"), a range ("0-1023") or a
+ * strided range ("0-1023:4"); several may be joined with commas. Every
+ * minterm is checked against literals_count and deduplicated in a bitmap
+ * (or, past BITMAP_MAX_LITERALS, a sorted list) before any Term is built.
+ * Malformed tokens throw std::runtime_error.
+ */
+class MintermReader {
+    public:
+        enum Set {
+            SOP,
+            POS,
+            DONT_CARE,
+            OFF,
+            SETS_COUNT
+        };
+
+        static const size_t BITMAP_MAX_LITERALS = 26;
+
+        MintermReader(size_t literals_count);
+
+        virtual ~MintermReader();
+
+        void addToken(Set set, const std::string& token);
+
+        /**
+         * Streams an input file: whitespace separated tokens, where the
+         * keywords "sop", "pos", "dc" (or "dont-care") and "off" switch the
+         * set the following tokens go to (initially "sop"), and '#' starts a
+         * comment.
+         */
+        void read(std::istream& input);
+
+        // the set's minterms, sorted and without duplicates
+        void getValues(Set set, std::vector<unsigned int>& values) const;
+
+    private:
+        void addToken(Set set, const char* begin, const char* end);
+
+        unsigned int parseNumber(const char*& position, const char* end, const char* token_begin) const;
+
+        void add(Set set, unsigned int minterm);
+
+        size_t _literals_count;
+        unsigned int _max_minterm;
+        std::vector<Bitmap> _bitmaps;
+        std::vector<std::vector<unsigned int> > _lists;
+};
+
+#endif
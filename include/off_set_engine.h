@@ -0,0 +1,23 @@
+#ifndef OFF_SET_ENGINE_H
+#define OFF_SET_ENGINE_H
+
+#include "../include/term.h"
+
+#include <vector>
+
+/**
+ * Prime generation for a function given by its ON and OFF minterms, every
+ * other minterm being a Dont-Care that is never enumerated. A cube holding
+ * the ON minterm m misses the OFF minterm o iff one of its literals is on a
+ * variable where m and o differ, so the primes holding m are the minimal
+ * hitting sets (as literal masks) of { m ^ o : o in OFF }. They are built
+ * with Berge's incremental algorithm, one ON minterm at a time, and every
+ * prime is appended once to terms (which owns them) and primeTerms. Takes
+ * O(|ON| |OFF| h) time for h hitting sets per minterm, however many
+ * Dont-Cares there are.
+ */
+void off_set_terms(const std::vector<unsigned int>& onValues,
+                   const std::vector<unsigned int>& offValues,
+                   size_t literals_count, Terms& terms, Terms& primeTerms);
+
+#endif
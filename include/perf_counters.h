@@ -0,0 +1,69 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Hardware performance counters (Linux perf_event_open) attributed to the
+ * phases of the algorithm. Every counter is opened on its own, so a counter
+ * the kernel (or the container) refuses is simply reported as unavailable
+ * while wall time and the remaining counters are still collected. The
+ * counters are inherited by the threads started after they were opened,
+ * and a thread's counts join the phase it exits in, so a phase counts the
+ * worker threads it starts and joins.
+ */
+class PerfCounters {
+    public:
+        enum Counter {
+            CYCLES,
+            INSTRUCTIONS,
+            CACHE_MISSES,
+            BRANCH_MISSES,
+            COUNTERS_COUNT
+        };
+
+        PerfCounters();
+
+        virtual ~PerfCounters();
+
+        bool isAvailable() const;
+
+        bool isAvailable(Counter counter) const;
+
+        std::string getUnavailableReason() const;
+
+        void startPhase(const std::string& name);
+
+        void stopPhase();
+
+        void report(std::ostream& output, size_t implicants_count) const;
+
+    private:
+        struct Phase {
+            Phase(const std::string& phase_name) :
+                name(phase_name),
+                wall_ms(0),
+                values()
+            {
+            }
+
+            std::string name;
+            double wall_ms;
+            uint64_t values[COUNTERS_COUNT];
+        };
+
+        PerfCounters(const PerfCounters&);
+
+        PerfCounters& operator=(const PerfCounters&);
+
+        int _fds[COUNTERS_COUNT];
+        std::string _unavailable_reason;
+        std::vector<Phase> _phases;
+        bool _running;
+        double _phase_start;
+};
+
+#endif
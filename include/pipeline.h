@@ -0,0 +1,22 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "../include/term.h"
+#include "../include/cover.h"
+
+/**
+ * Pipelined combine phase. Implicants are kept in groups by level (number
+ * of dashes) and popcount, and merging group (k, p) with (k, p + 1) is a
+ * task of its own, run by threads_count workers as soon as both groups are
+ * final - so level k + 1 starts long before level k is drained. Once a
+ * group's two merge tasks are done its unselected implicants are known to
+ * be prime, and they are streamed into chart (by the calling thread) while
+ * the workers carry on.
+ *
+ * terms holds the minterm terms (Dont-Cares flagged with dontCare()); new
+ * implicants are appended to it (it owns them), and the primes are appended
+ * to primeTerms in the order they were added to chart.
+ */
+void pipelined_terms(Terms& terms, Terms& primeTerms, CoverChart& chart, size_t threads_count);
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef QMC_H
+#define QMC_H
+
+#include <array>
+#include <cstddef>
+
+/**
+ * Header-only, compile time minimization (C++14) for functions that are
+ * known when the program is built:
+ *
+ *   constexpr std::array<unsigned int, 10> on = {{ 0, 1, 2, 5, 6, 7, 8, 9, 10, 14 }};
+ *   constexpr std::array<unsigned int, 0> dont_cares = {{}};
+ *   constexpr auto f = qmc::minimize<4>(on, dont_cares);
+ *   static_assert(f.size == 3 && f.evaluate(14) && !f.evaluate(3), "");
+ *
+ * It follows the tabular engine: implicants are merged level by level
+ * (pairs one bit apart with the same dashes), the ones never merged that
+ * hold an ON minterm are the primes, and the cover takes the essential
+ * primes and then the prime covering the most uncovered ON minterms, as
+ * select_cover() does. The work grows with 3^Literals implicants, so it is
+ * meant for small (decoder sized) functions; larger ones may run into the
+ * compiler's constexpr evaluation limits.
+ */
+namespace qmc {
+    /**
+     * (value, dash mask) as in cube_input.h: literal 'a' is the most
+     * significant of the Literals bits.
+     */
+    struct Cube {
+        unsigned int value;
+        unsigned int dash_mask;
+
+        constexpr bool contains(unsigned int minterm) const {
+            return (minterm & ~dash_mask) == value;
+        }
+    };
+
+    template <std::size_t Capacity>
+    struct Cover {
+        Cube cubes[Capacity];
+        std::size_t size;
+
+        constexpr bool evaluate(unsigned int input) const {
+            for (std::size_t i = 0; i < size; ++i) {
+                if (cubes[i].contains(input)) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    namespace detail {
+        constexpr std::size_t implicants_capacity(std::size_t literals) {
+            return literals == 0 ? 1 : 3 * implicants_capacity(literals - 1);
+        }
+
+        // next minterm of a cube after offset, counting over its dash bits;
+        // wraps back to 0 after the last one
+        constexpr unsigned int next_offset(unsigned int offset, unsigned int dash_mask) {
+            return (offset - dash_mask) & dash_mask;
+        }
+
+        struct Implicant {
+            Cube cube;
+            bool merged;
+        };
+
+        template <std::size_t Literals>
+        struct Implicants {
+            Implicant items[implicants_capacity(Literals)];
+            std::size_t size;
+
+            constexpr bool contains(const Cube& cube) const {
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (items[i].cube.value == cube.value && items[i].cube.dash_mask == cube.dash_mask) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            constexpr void add(const Cube& cube) {
+                items[size].cube = cube;
+                items[size].merged = false;
+                size++;
+            }
+        };
+    }
+
+    template <std::size_t Literals, std::size_t OnCount, std::size_t DontCareCount>
+    constexpr Cover<(1u << Literals)> minimize(const std::array<unsigned int, OnCount>& minterms,
+                                                const std::array<unsigned int, DontCareCount>& dont_cares)
+    {
+        static_assert(Literals >= 1 && Literals <= 8, "compile time minimization supports 1 to 8 literals");
+
+        const unsigned int minterms_count = 1u << Literals;
+
+        bool on[1u << Literals] = {};
+        bool care[1u << Literals] = {};
+        for (std::size_t i = 0; i < OnCount; ++i) {
+            on[minterms[i]] = true;
+            care[minterms[i]] = true;
+        }
+
+        for (std::size_t i = 0; i < DontCareCount; ++i) {
+            care[dont_cares[i]] = true;
+        }
+
+        // combine: level k holds the implicants with k dashes, stored one
+        // level after the other
+        detail::Implicants<Literals> implicants = {};
+        for (unsigned int minterm = 0; minterm < minterms_count; ++minterm) {
+            if (care[minterm]) {
+                implicants.add(Cube{ minterm, 0 });
+            }
+        }
+
+        std::size_t level_begin = 0;
+        while (level_begin < implicants.size) {
+            std::size_t level_end = implicants.size;
+            for (std::size_t i = level_begin; i < level_end; ++i) {
+                for (std::size_t j = level_begin; j < level_end; ++j) {
+                    const Cube& low = implicants.items[i].cube;
+                    const Cube& high = implicants.items[j].cube;
+                    unsigned int bit = high.value ^ low.value;
+
+                    // high has exactly one more 1 than low, in the same place
+                    if (low.dash_mask != high.dash_mask || (high.value & bit) == 0 || (bit & (bit - 1)) != 0) {
+                        continue;
+                    }
+
+                    implicants.items[i].merged = true;
+                    implicants.items[j].merged = true;
+
+                    Cube merged = { low.value, low.dash_mask | bit };
+                    if (!implicants.contains(merged)) {
+                        implicants.add(merged);
+                    }
+                }
+            }
+
+            level_begin = level_end;
+        }
+
+        // primes holding an ON minterm
+        Cube primes[detail::implicants_capacity(Literals)] = {};
+        std::size_t primes_count = 0;
+        for (std::size_t i = 0; i < implicants.size; ++i) {
+            if (implicants.items[i].merged) {
+                continue;
+            }
+
+            const Cube& cube = implicants.items[i].cube;
+            unsigned int offset = 0;
+            do {
+                if (on[cube.value | offset]) {
+                    primes[primes_count++] = cube;
+                    break;
+                }
+
+                offset = detail::next_offset(offset, cube.dash_mask);
+            } while (offset != 0);
+        }
+
+        // cover: essential primes first, then the best remaining prime
+        Cover<(1u << Literals)> cover = {};
+        bool chosen[detail::implicants_capacity(Literals)] = {};
+        bool covered[1u << Literals] = {};
+        for (unsigned int minterm = 0; minterm < minterms_count; ++minterm) {
+            if (!on[minterm]) {
+                continue;
+            }
+
+            std::size_t holders = 0;
+            std::size_t holder = 0;
+            for (std::size_t p = 0; p < primes_count; ++p) {
+                if (primes[p].contains(minterm)) {
+                    holders++;
+                    holder = p;
+                }
+            }
+
+            if (holders == 1) {
+                chosen[holder] = true;
+            }
+        }
+
+        for (std::size_t p = 0; p < primes_count; ++p) {
+            if (!chosen[p]) {
+                continue;
+            }
+
+            cover.cubes[cover.size++] = primes[p];
+            unsigned int offset = 0;
+            do {
+                covered[primes[p].value | offset] = true;
+                offset = detail::next_offset(offset, primes[p].dash_mask);
+            } while (offset != 0);
+        }
+
+        for (;;) {
+            std::size_t best = 0;
+            std::size_t best_gain = 0;
+            for (std::size_t p = 0; p < primes_count; ++p) {
+                std::size_t gain = 0;
+                unsigned int offset = 0;
+                do {
+                    unsigned int minterm = primes[p].value | offset;
+                    if (on[minterm] && !covered[minterm]) {
+                        gain++;
+                    }
+
+                    offset = detail::next_offset(offset, primes[p].dash_mask);
+                } while (offset != 0);
+
+                if (gain > best_gain) {
+                    best = p;
+                    best_gain = gain;
+                }
+            }
+
+            if (best_gain == 0) {
+                break;
+            }
+
+            cover.cubes[cover.size++] = primes[best];
+            unsigned int offset = 0;
+            do {
+                covered[primes[best].value | offset] = true;
+                offset = detail::next_offset(offset, primes[best].dash_mask);
+            } while (offset != 0);
+        }
+
+        return cover;
+    }
+}
+
+#endif
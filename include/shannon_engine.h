@@ -0,0 +1,28 @@
+#ifndef SHANNON_ENGINE_H
+#define SHANNON_ENGINE_H
+
+#include "../include/bitmap.h"
+#include "../include/term.h"
+
+/**
+ * Divide and conquer prime generation on Shannon cofactors. With
+ * f = x'f0 + xf1 on the top variable x,
+ *
+ *   P(f) = P(f0f1) + x'(P(f0) \ P(f0f1)) + x(P(f1) \ P(f0f1))
+ *
+ * where P(f0f1) is the pairwise intersections of P(f0) and P(f1) with the
+ * contained cubes dropped. The primes of the ON and Dont-Care sets are
+ * computed this way, cofactors that are constant ending the recursion; a
+ * cofactor on the top variables is a contiguous range of the bitmap, so
+ * every subproblem works on its own block of memory. The function is
+ * split on enough top variables for threads_count threads to share the
+ * cofactors, and the merges of each level run in parallel as well. Only
+ * the primes touching the ON-set become Terms; they are appended to terms
+ * (which owns them) and to primeTerms.
+ */
+const size_t SHANNON_MAX_LITERALS = 26;
+
+void shannon_terms(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count,
+                   size_t threads_count, Terms& terms, Terms& primeTerms);
+
+#endif
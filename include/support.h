@@ -0,0 +1,25 @@
+#ifndef SUPPORT_H
+#define SUPPORT_H
+
+#include "../include/bitmap.h"
+#include "../include/cube_input.h"
+
+#include <vector>
+
+/**
+ * Support reduction. A variable is vacuous when its two cofactors are the
+ * same function: the ON-sets and the Dont-Care sets of both halves are
+ * equal, which is checked with whole-word comparisons. Dont-Cares are never
+ * filled in to make a variable vacuous, as that would fix them before the
+ * cover is chosen and could cost it its minimality. At least one variable
+ * is kept. Returns the mask of the vacuous variables.
+ */
+unsigned int drop_vacuous_variables(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count);
+
+// the set minterms whose dropped variables are 0, packed over the kept ones
+void reduced_values(const Bitmap& set, unsigned int vacuous, std::vector<unsigned int>& values);
+
+// a cube of the reduced function, spread back with the dropped variables dashed
+Cube spread_cube(const Cube& cube, unsigned int vacuous, size_t literals_count);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SYMMETRIC_ENGINE_H
+#define SYMMETRIC_ENGINE_H
+
+#include "../include/bitmap.h"
+#include "../include/term.h"
+
+#include <ostream>
+#include <vector>
+
+/**
+ * Weight boxes (see SymmetricFunction) the symmetric engine handles at most;
+ * the weight grid of a function with little symmetry is too fine for it.
+ */
+const size_t SYMMETRIC_MAX_BOXES = (size_t)1 << 20;
+
+/**
+ * Closed-form primes of (partially) symmetric functions. Two variables are
+ * symmetric when swapping them maps the ON-set and the Dont-Care set onto
+ * themselves; the variables split into blocks of symmetric ones, checked
+ * against the first variable of each block. f then only depends on the
+ * weights (numbers of ones) of the blocks, a point of the weight grid.
+ *
+ * A cube with p positive and q negative literals in a block of s variables
+ * spans the weights p..s-q there, so over all blocks it spans a box of the
+ * grid. It is an implicant iff its box holds care points only, and a prime
+ * iff no side of the box can be pushed out by one; the primes touching the
+ * ON-set are those of the maximal boxes holding an ON point. The boxes are
+ * found on the grid, and each one becomes its primes directly: every way
+ * of picking p positive and q negative literals in each block. Majority of
+ * n, for one, is the single box of weights n/2+1..n, and C(n, n/2+1) primes
+ * without a single merge.
+ */
+class SymmetricFunction {
+    public:
+        SymmetricFunction(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count);
+
+        virtual ~SymmetricFunction();
+
+        // one variable mask per block, by lowest variable
+        const std::vector<unsigned int>& getBlocks() const;
+
+        // some block holds two variables or more
+        bool isSymmetric() const;
+
+        // the grid is small enough for generate()
+        bool isTractable() const;
+
+        // the number of primes generate() makes (tractable functions only)
+        double getPrimesCount() const;
+
+        /**
+         * Appends the primes touching the ON-set to terms (which owns them)
+         * and to primeTerms.
+         */
+        void generate(Terms& terms, Terms& primeTerms) const;
+
+        // the blocks in literal names, as "{abc} {d} {e}"
+        void print(std::ostream& output) const;
+
+    private:
+        bool isSymmetricPair(const Bitmap& set, unsigned int first, unsigned int second) const;
+
+        bool evaluate(size_t box, std::vector<char>& memo, const std::vector<char>& points, bool every) const;
+
+        size_t _literals_count;
+        std::vector<unsigned int> _blocks;
+        std::vector<size_t> _strides;
+        std::vector<size_t> _maximal_boxes;
+        double _primes_count;
+};
+
+#endif
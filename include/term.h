@@ -16,16 +16,23 @@ class Term : public Binary {
 
         struct PrimeImplicantCandidatesCompare {
             bool operator()(const Term* left, const Term* right) {
-                return (left->getRemainingMinterms().size() >= right->getRemainingMinterms().size());
+                // strict ordering - std::sort walks out of range with >=
+                return (left->getRemainingMintermsCount() > right->getRemainingMintermsCount());
             }
         };
 
         Term(unsigned int num, size_t literals_count);
 
+        Term(unsigned int num, unsigned int dash_mask, size_t literals_count);
+
         Term(Term& first, Term& second, size_t new_dash); 
         
         virtual ~Term();
 
+        static void* operator new(size_t size);
+
+        static void operator delete(void* pointer, size_t size);
+
         std::string getExpression() const;
 
         void addDash(size_t i);
@@ -56,6 +63,8 @@ class Term : public Binary {
         
         std::vector<size_t>& getDashes();
 
+        unsigned int getDashMask() const;
+
         std::string getDecimals() const;
         
         size_t getLiteralCount() const;
@@ -70,7 +79,13 @@ class Term : public Binary {
 
         std::vector<size_t> getRemainingMinterms() const;
 
+        size_t getRemainingMintermsCount() const;
+
     private:
+        void charge();
+
+        void enumerateMinterms(std::vector<size_t>& minterms) const;
+
         std::vector<size_t> _dashes;
         std::vector<size_t> _minterms;
         std::vector<size_t> _remaining_minterms;
@@ -78,6 +93,9 @@ class Term : public Binary {
         bool _prime_implicant;
         bool _dont_care;
         size_t _literals_count;
+        size_t _charged_bytes;
 };
 
+typedef std::vector<Term*> Terms;
+
 #endif
@@ -0,0 +1,22 @@
+#ifndef TERNARY_ENGINE_H
+#define TERNARY_ENGINE_H
+
+#include "../include/bitmap.h"
+#include "../include/term.h"
+
+/**
+ * Bit-parallel prime generation for dense functions of up to
+ * TERNARY_MAX_LITERALS variables. Every dash mask gets a bitmap over the
+ * values of its free bits, with a bit set for each implicant: a cube is an
+ * implicant iff both of its halves are, so a level is computed from the
+ * previous one with whole-word ANDs (and shifts within a word). A set bit
+ * none of whose neighbours is set is a prime. Only the primes touching the
+ * ON-set become Terms; they are appended to terms (which owns them) and to
+ * primeTerms.
+ */
+const size_t TERNARY_MAX_LITERALS = 16;
+
+void ternary_terms(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count,
+                   Terms& terms, Terms& primeTerms);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef ZDD_ENGINE_H
+#define ZDD_ENGINE_H
+
+#include "../include/term.h"
+
+#include <vector>
+
+/**
+ * Implicit engine: builds the ON + Dont-Care function as a BDD, computes the
+ * complete prime set as a ZDD (Coudert-Madre) and selects the cover from the
+ * ZDD, extracting essential primes first and then, for the cyclic core, the
+ * hardest uncovered minterm's best prime, searched on the diagrams against
+ * the uncovered minterms' BDD (see DecisionDiagram::zddBestCube()). Only
+ * the selected cubes are materialized as Terms, so memory follows the
+ * diagram sizes instead of the number of primes, which is returned in
+ * primes_count.
+ */
+Terms zdd_minimize(const std::vector<unsigned int>& onValues,
+                   const std::vector<unsigned int>& dontCareValues,
+                   size_t literals_count,
+                   double& primes_count);
+
+#endif
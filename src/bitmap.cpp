@@ -0,0 +1,51 @@
+#include "../include/bitmap.h"
+
+Bitmap::Bitmap() :
+    _words(),
+    _size(0)
+{
+}
+
+Bitmap::Bitmap(size_t size) :
+    _words((size + 63) / 64, 0),
+    _size(size)
+{
+}
+
+Bitmap::~Bitmap() {
+}
+
+size_t Bitmap::size() const {
+    return _size;
+}
+
+bool Bitmap::test(size_t i) const {
+    return (_words[i >> 6] >> (i & 63)) & 1;
+}
+
+void Bitmap::set(size_t i) {
+    _words[i >> 6] |= (uint64_t)1 << (i & 63);
+}
+
+void Bitmap::reset(size_t i) {
+    _words[i >> 6] &= ~((uint64_t)1 << (i & 63));
+}
+
+size_t Bitmap::count() const {
+    size_t count = 0;
+    for (std::vector<uint64_t>::const_iterator it = _words.begin();
+         it < _words.end(); ++it)
+    {
+        count += __builtin_popcountll(*it);
+    }
+
+    return count;
+}
+
+std::vector<uint64_t>& Bitmap::getWords() {
+    return _words;
+}
+
+const std::vector<uint64_t>& Bitmap::getWords() const {
+    return _words;
+}
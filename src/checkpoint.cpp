@@ -0,0 +1,344 @@
+#include "../include/checkpoint.h"
+#include "../include/deadline.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <tr1/unordered_set>
+
+namespace {
+    const char MAGIC[4] = { 'Q', 'M', 'C', 'K' };
+    const uint32_t VERSION = 1;
+
+    const uint8_t DONT_CARE = 1;
+    const uint8_t SELECTED = 2;
+    const uint8_t SEPARATOR = 4;
+    const uint8_t IN_COVER = 8;
+
+    // the number of sections each phase saves
+    const size_t COMBINE_SECTIONS = 3;  // queue, current terms, primes
+    const size_t PRIMES_SECTIONS = 1;   // primes
+    const size_t COVER_SECTIONS = 1;    // cover
+    const size_t SEARCH_SECTIONS = 1;   // primes, the best cover's marked
+
+    // FNV-1a, over the bytes of each value
+    void hash(uint64_t& fingerprint, uint64_t value) {
+        for (size_t i = 0; i < sizeof(value); ++i) {
+            fingerprint = (fingerprint ^ ((value >> (8 * i)) & 0xff)) * 1099511628211ull;
+        }
+    }
+
+    void hash(uint64_t& fingerprint, std::vector<unsigned int> values) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        hash(fingerprint, values.size());
+        for (std::vector<unsigned int>::iterator it = values.begin(); it < values.end(); ++it) {
+            hash(fingerprint, *it);
+        }
+    }
+
+    template <typename T>
+    void write(std::ostream& output, T value) {
+        output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    T read(std::istream& input) {
+        T value = T();
+        input.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    size_t sections_count(Checkpoint::Phase phase) {
+        switch (phase) {
+            case Checkpoint::COMBINE:
+                return COMBINE_SECTIONS;
+            case Checkpoint::PRIMES:
+                return PRIMES_SECTIONS;
+            case Checkpoint::COVER:
+                return COVER_SECTIONS;
+            case Checkpoint::SEARCH:
+                return SEARCH_SECTIONS;
+            default:
+                return 0;
+        }
+    }
+}
+
+Checkpoint::Checkpoint(const std::string& directory, double interval_ms, bool resume) :
+    _directory(directory),
+    _interval_ms(interval_ms),
+    _resume(resume),
+    _saved_at(Deadline::now()),
+    _literals_count(0),
+    _fingerprint(0),
+    _phase(EMPTY),
+    _sections(),
+    _cover_result(),
+    _searched(false)
+{
+    if (mkdir(_directory.c_str(), 0777) != 0 && errno != EEXIST) {
+        throw std::runtime_error("cannot create checkpoint directory '" + _directory + "': " +
+                                 strerror(errno));
+    }
+}
+
+Checkpoint::~Checkpoint() {
+}
+
+void Checkpoint::open(const std::vector<unsigned int>& onValues,
+                      const std::vector<unsigned int>& dontCareValues, size_t literals_count)
+{
+    _literals_count = literals_count;
+    _fingerprint = 14695981039346656037ull;
+    hash(_fingerprint, literals_count);
+    hash(_fingerprint, onValues);
+    hash(_fingerprint, dontCareValues);
+
+    _phase = EMPTY;
+    _sections.clear();
+    _saved_at = Deadline::now();
+    if (_resume) {
+        load();
+    }
+}
+
+Checkpoint::Phase Checkpoint::getPhase() const {
+    return _phase;
+}
+
+bool Checkpoint::isDue() const {
+    return Deadline::now() - _saved_at >= _interval_ms;
+}
+
+void Checkpoint::saveCombine(std::queue<Term*> termsQueue, const Terms& currentTerms, const Terms& primeTerms) {
+    Records queueRecords;
+    queueRecords.reserve(termsQueue.size());
+    for (; !termsQueue.empty(); termsQueue.pop()) {
+        Term* term = termsQueue.front();
+        if (term == 0) {
+            Record separator;
+            separator.flags = SEPARATOR;
+            queueRecords.push_back(separator);
+        } else {
+            toRecords(Terms(1, term), queueRecords);
+        }
+    }
+
+    Records currentRecords;
+    Records primeRecords;
+    toRecords(currentTerms, currentRecords);
+    toRecords(primeTerms, primeRecords);
+
+    std::vector<const Records*> sections;
+    sections.push_back(&queueRecords);
+    sections.push_back(&currentRecords);
+    sections.push_back(&primeRecords);
+    save(COMBINE, sections);
+}
+
+void Checkpoint::savePrimes(const Terms& primeTerms) {
+    Records primeRecords;
+    toRecords(primeTerms, primeRecords);
+
+    std::vector<const Records*> sections(1, &primeRecords);
+    save(PRIMES, sections);
+}
+
+void Checkpoint::saveCover(const Terms& cover, const CoverResult& coverResult, bool searched) {
+    Records coverRecords;
+    toRecords(cover, coverRecords);
+
+    _cover_result.cost = coverResult.cost;
+    _cover_result.lower_bound = coverResult.lower_bound;
+    _cover_result.optimal = coverResult.optimal;
+    _searched = searched;
+
+    std::vector<const Records*> sections(1, &coverRecords);
+    save(COVER, sections);
+}
+
+void Checkpoint::saveSearch(const Terms& primeTerms, const Terms& cover) {
+    Records primeRecords;
+    toRecords(primeTerms, primeRecords);
+
+    std::tr1::unordered_set<const Term*> chosen(cover.begin(), cover.end());
+    for (size_t i = 0; i < primeTerms.size(); ++i) {
+        if (chosen.count(primeTerms[i])) {
+            primeRecords[i].flags |= IN_COVER;
+        }
+    }
+
+    std::vector<const Records*> sections(1, &primeRecords);
+    save(SEARCH, sections);
+}
+
+void Checkpoint::restoreCombine(std::queue<Term*>& termsQueue, Terms& currentTerms, Terms& primeTerms,
+                                Terms& terms) const
+{
+    const Records& queueRecords = _sections[0];
+    for (Records::const_iterator it = queueRecords.begin(); it < queueRecords.end(); ++it) {
+        if (it->flags & SEPARATOR) {
+            termsQueue.push(0);
+        } else {
+            Term* term = toTerm(*it);
+            terms.push_back(term); // add to heap pointers vector
+            termsQueue.push(term);
+        }
+    }
+
+    restore(_sections[1], currentTerms, terms);
+    restore(_sections[2], primeTerms, terms);
+}
+
+void Checkpoint::restorePrimes(Terms& primeTerms, Terms& terms) const {
+    restore(_sections[0], primeTerms, terms);
+}
+
+void Checkpoint::restoreSearch(const Terms& primeTerms, Terms& cover) const {
+    const Records& primeRecords = _sections[0];
+    for (size_t i = 0; i < primeRecords.size() && i < primeTerms.size(); ++i) {
+        if (primeRecords[i].flags & IN_COVER) {
+            cover.push_back(primeTerms[i]);
+        }
+    }
+}
+
+void Checkpoint::restoreCover(Terms& cover, CoverResult& coverResult, bool& searched, Terms& terms) const {
+    restore(_sections[0], cover, terms);
+    coverResult.cover = cover;
+    coverResult.cost = _cover_result.cost;
+    coverResult.lower_bound = _cover_result.lower_bound;
+    coverResult.optimal = _cover_result.optimal;
+    searched = _searched;
+}
+
+void Checkpoint::toRecords(const Terms& terms, Records& records) {
+    for (Terms::const_iterator it = terms.begin(); it < terms.end(); ++it) {
+        Record record;
+        record.dash_mask = (*it)->getDashMask();
+        record.value = (*it)->getDecimal() & ~record.dash_mask;
+        record.flags = ((*it)->isDontCare() ? DONT_CARE : 0) | ((*it)->isSelected() ? SELECTED : 0);
+        records.push_back(record);
+    }
+}
+
+Term* Checkpoint::toTerm(const Record& record) const {
+    Term* term = new Term(record.value, record.dash_mask, _literals_count);
+    if (record.flags & DONT_CARE) {
+        term->dontCare();
+    }
+
+    if (record.flags & SELECTED) {
+        term->select();
+    }
+
+    return term;
+}
+
+void Checkpoint::restore(const Records& records, Terms& restored, Terms& terms) const {
+    for (Records::const_iterator it = records.begin(); it < records.end(); ++it) {
+        Term* term = toTerm(*it);
+        terms.push_back(term); // add to heap pointers vector
+        restored.push_back(term);
+    }
+}
+
+void Checkpoint::load() {
+    std::string path = _directory + "/checkpoint.qmc";
+    std::ifstream input(path.c_str(), std::ios::binary);
+    if (!input) {
+        std::cerr << "checkpoint: nothing to resume in '" << _directory << "', starting over" << std::endl;
+        return;
+    }
+
+    char magic[sizeof(MAGIC)];
+    input.read(magic, sizeof(magic));
+    if (!input || !std::equal(magic, magic + sizeof(magic), MAGIC) || read<uint32_t>(input) != VERSION) {
+        throw std::runtime_error("'" + path + "' is not a checkpoint of this version");
+    }
+
+    uint32_t literals_count = read<uint32_t>(input);
+    uint64_t fingerprint = read<uint64_t>(input);
+    uint32_t phase = read<uint32_t>(input);
+    if (!input || literals_count != _literals_count || fingerprint != _fingerprint) {
+        throw std::runtime_error("'" + path + "' was written for another function");
+    }
+
+    if (phase != COMBINE && phase != PRIMES && phase != COVER && phase != SEARCH) {
+        throw std::runtime_error("'" + path + "' is corrupt");
+    }
+
+    std::vector<Records> sections(sections_count((Phase)phase));
+    for (std::vector<Records>::iterator section = sections.begin(); section < sections.end(); ++section) {
+        uint64_t records_count = read<uint64_t>(input);
+        for (uint64_t i = 0; input && i < records_count; ++i) {
+            Record record;
+            record.value = read<uint32_t>(input);
+            record.dash_mask = read<uint32_t>(input);
+            record.flags = read<uint8_t>(input);
+            section->push_back(record);
+        }
+    }
+
+    if (phase == COVER) {
+        _cover_result.cost = read<uint64_t>(input);
+        _cover_result.lower_bound = read<uint64_t>(input);
+        uint8_t flags = read<uint8_t>(input);
+        _cover_result.optimal = flags & 1;
+        _searched = flags & 2;
+    }
+
+    if (!input) {
+        throw std::runtime_error("'" + path + "' is truncated");
+    }
+
+    _phase = (Phase)phase;
+    _sections.swap(sections);
+}
+
+/**
+ * Writes the whole checkpoint to a temporary file and renames it over the
+ * last one. A checkpoint that cannot be written is reported and skipped: the
+ * run itself goes on.
+ */
+void Checkpoint::save(Phase phase, const std::vector<const Records*>& sections) {
+    std::string temporary = _directory + "/checkpoint.tmp";
+    std::string path = _directory + "/checkpoint.qmc";
+    std::ofstream output(temporary.c_str(), std::ios::binary | std::ios::trunc);
+
+    output.write(MAGIC, sizeof(MAGIC));
+    write<uint32_t>(output, VERSION);
+    write<uint32_t>(output, _literals_count);
+    write<uint64_t>(output, _fingerprint);
+    write<uint32_t>(output, phase);
+    for (std::vector<const Records*>::const_iterator section = sections.begin();
+         section < sections.end(); ++section)
+    {
+        write<uint64_t>(output, (*section)->size());
+        for (Records::const_iterator it = (*section)->begin(); it < (*section)->end(); ++it) {
+            write<uint32_t>(output, it->value);
+            write<uint32_t>(output, it->dash_mask);
+            write<uint8_t>(output, it->flags);
+        }
+    }
+
+    if (phase == COVER) {
+        write<uint64_t>(output, _cover_result.cost);
+        write<uint64_t>(output, _cover_result.lower_bound);
+        write<uint8_t>(output, (_cover_result.optimal ? 1 : 0) | (_searched ? 2 : 0));
+    }
+
+    output.close();
+    if (!output || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::cerr << "checkpoint: cannot write '" << path << "': " << strerror(errno) << std::endl;
+    }
+
+    _saved_at = Deadline::now();
+}
@@ -0,0 +1,113 @@
+#include "../include/code_emitter.h"
+#include "../include/cover_evaluator.h"
+
+#include <iomanip>
+
+namespace {
+    unsigned int all_bits(size_t literals_count) {
+        return (literals_count == 32) ? ~0u : ((1u << literals_count) - 1);
+    }
+}
+
+void emit_c(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+            const std::string& name, const std::string& comment, bool inverted)
+{
+    unsigned int all = all_bits(literals_count);
+
+    output << "/* " << comment << " */" << std::endl;
+    output << "static inline int " << name << "(unsigned int x) {" << std::endl;
+    if (cover.empty()) {
+        output << "    return " << (inverted ? 1 : 0) << ";" << std::endl;
+    }
+
+    const char* first = inverted ? "    return !(" : "    return ";
+    const char* next = inverted ? "           | " : "         | ";
+    const char* last = inverted ? ");" : ";";
+    for (size_t i = 0; i < cover.size(); ++i) {
+        unsigned int care = all & ~cover[i].second;
+        output << (i == 0 ? first : next)
+               << "((x & 0x" << std::hex << care << "u) == 0x"
+               << (cover[i].first & care) << "u)" << std::dec
+               << (i + 1 == cover.size() ? last : "") << std::endl;
+    }
+
+    output << "}" << std::endl;
+}
+
+void emit_table(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+                const std::string& name, const std::string& comment, bool inverted)
+{
+    // the truth table comes from the bit-sliced evaluator, 256 bits a block
+    CoverEvaluator evaluator(cover, literals_count);
+    size_t inputs_count = (size_t)1 << literals_count;
+    size_t words_count = (inputs_count + 63) / 64;
+    std::vector<uint64_t> words;
+    for (size_t block = 0; words.size() < words_count; ++block) {
+        CoverEvaluator::Slice values;
+        evaluator.evaluateBlock(block, values);
+        for (size_t w = 0; w < CoverEvaluator::SLICE_BITS / 64 && words.size() < words_count; ++w) {
+            words.push_back(values[w]);
+        }
+    }
+
+    if (inverted) {
+        for (size_t w = 0; w < words_count; ++w) {
+            words[w] = ~words[w];
+        }
+    }
+
+    if (inputs_count < 64) {
+        words[0] &= ((uint64_t)1 << inputs_count) - 1;
+    }
+
+    output << "/* " << comment << " */" << std::endl;
+    output << "static const unsigned long long " << name << "_table[" << words_count << "] = {" << std::endl;
+    for (size_t w = 0; w < words_count; ++w) {
+        output << ((w % 4 == 0) ? "    " : " ")
+               << "0x" << std::hex << std::setw(16) << std::setfill('0') << words[w] << "ULL"
+               << std::dec << std::setfill(' ')
+               << ((w + 1 == words_count) ? "\n" : ((w % 4 == 3) ? ",\n" : ","));
+    }
+
+    output << "};" << std::endl << std::endl;
+    output << "static inline int " << name << "(unsigned int x) {" << std::endl;
+    output << "    return (int)((" << name << "_table[x >> 6] >> (x & 63)) & 1);" << std::endl;
+    output << "}" << std::endl;
+}
+
+void emit_verilog(std::ostream& output, const std::vector<Cube>& cover, size_t literals_count,
+                  const std::string& name, const std::string& comment, bool inverted)
+{
+    output << "// " << comment << std::endl;
+    output << "module " << name << " (" << std::endl;
+    output << "    input  wire [" << literals_count - 1 << ":0] x," << std::endl;
+    output << "    output wire y" << std::endl;
+    output << ");" << std::endl;
+
+    if (cover.empty()) {
+        output << "    assign y = " << (inverted ? "1'b1" : "1'b0") << ";" << std::endl;
+    }
+
+    const char* first_product = inverted ? "    assign y = ~(" : "    assign y = ";
+    const char* next_product = inverted ? "               | " : "             | ";
+    const char* last = inverted ? ");" : ";";
+    for (size_t i = 0; i < cover.size(); ++i) {
+        output << (i == 0 ? first_product : next_product) << "(";
+
+        // literal 'a' first, as in the "f = ..." form
+        bool first = true;
+        for (size_t variable = literals_count; variable-- > 0; ) {
+            if (cover[i].second & (1u << variable)) {
+                continue;
+            }
+
+            output << (first ? "" : " & ") << (((cover[i].first >> variable) & 1) ? "" : "~")
+                   << "x[" << variable << "]";
+            first = false;
+        }
+
+        output << (first ? "1'b1" : "") << ")" << (i + 1 == cover.size() ? last : "") << std::endl;
+    }
+
+    output << "endmodule" << std::endl;
+}
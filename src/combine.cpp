@@ -0,0 +1,347 @@
+#include "../include/combine.h"
+#include "../include/consensus.h"
+
+#include <algorithm>
+#include <queue>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <stdint.h>
+
+void combine_terms(Terms& terms, Terms& primeTerms, Checkpoint* checkpoint) {
+    std::queue<Term*> termsQueue;
+    Terms currentTerms;
+    Terms nextTerms;
+    if (checkpoint && checkpoint->getPhase() == Checkpoint::COMBINE) {
+        checkpoint->restoreCombine(termsQueue, currentTerms, primeTerms, terms);
+    } else {
+        std::sort(terms.begin(), terms.end(), Term::PointerCompare());
+
+        for (Terms::iterator it = terms.begin(); 
+            it < terms.end(); ++it) 
+        {
+            termsQueue.push(*it);
+        }
+
+        termsQueue.push(0); // separating the algorithm steps
+    }
+
+    while (!termsQueue.empty()) {
+        // 1. go over the queue, while adding to current terms
+        //    a. if 0 or different number of ones, stop adding.
+        //    b. if 0, add unselected to primes.
+        //    c. if number of ones is bigger by one, fetch until 0 or different number of ones.
+        //    d. compare and push to queue.
+        //    e. clear next and current.
+
+        Term* first;
+        Term* front;
+        bool match_terms = true;
+        bool find_next_terms = true;
+        if (currentTerms.empty()) {
+            // get the first term in the queue
+            first = termsQueue.front();
+            
+            // get all the terms in the queue with the same amount of
+            // ones in the binary representation
+            while (!termsQueue.empty()) {
+                front = termsQueue.front();
+                
+                if (front == 0 || first == 0) {
+                    termsQueue.pop();
+                    match_terms = false;
+                    find_next_terms = false;
+                    break;
+                }
+                
+                if ((front->oneCount() - first->oneCount()) > 1) {
+                    match_terms = false;
+                    find_next_terms = false;
+                    break;
+                }
+
+                if (front->oneCount() != first->oneCount()) {
+                    // difference is exactly 1.
+                    // we should start adding next terms.
+                    break;
+                }
+                
+                currentTerms.push_back(front);
+                termsQueue.pop();
+            }
+        }
+
+        // by now we have some currentTerms, and are ready to insert
+        // to nextTerms.
+
+        nextTerms.clear();
+        
+        if (find_next_terms && currentTerms.size() > 0) {
+            // get the first term in the queue
+            first = termsQueue.front();
+
+            // get all the terms in the queue with the same amount of
+            // ones in the binary representation
+            while (!termsQueue.empty()) {
+                front = termsQueue.front();
+
+                if (front == 0 || first == 0) {
+                    termsQueue.pop();
+                    termsQueue.push(0);
+                    break;
+                }
+
+                if (front->oneCount() != first->oneCount()) {
+                    // we should start processing the current terms sets.
+                    break;
+                }
+
+                nextTerms.push_back(front);
+                termsQueue.pop();
+            }
+        }
+        
+        if (match_terms && currentTerms.size() > 0 && nextTerms.size() > 0) {
+            // now we have two lists of terms - current and next, which
+            // are adjacent groups in a Quine-McCluskey table.
+            // we should compare each current term and next term and
+            // push new terms to the end of the queue.
+            for (Terms::iterator c_it = currentTerms.begin();
+                 c_it < currentTerms.end(); ++c_it)
+            {
+                Term* current_term = *c_it;
+                for (Terms::iterator n_it = nextTerms.begin();
+                     n_it < nextTerms.end(); ++n_it)
+                {
+                    Term* next_term = *n_it;
+                    int separating_bit = current_term->separatingBit(*next_term);
+                    if (separating_bit > -1) {
+                        current_term->select();
+                        next_term->select();
+
+                        Term* new_term = new Term(*current_term, 
+                                                  *next_term, 
+                                                  separating_bit+1);
+                        termsQueue.push(new_term);
+                        terms.push_back(new_term); // add to heap pointers vector
+                    }
+                }
+            }
+
+        }
+
+        // if we got here, we should try to add unselected terms
+        // from both current terms and next terms and then clear both lists.
+
+        for (Terms::iterator it = currentTerms.begin();
+             it < currentTerms.end(); ++it)
+        {
+            if (!(*it)->isSelected()) {
+                // make sure that we don't add terms that are made of
+                // only dont care terms.
+                if ((*it)->isDontCare()) {
+                    continue;
+                }
+
+                // make sure we don't have that term in the list already
+                // (that can happen because 0,8-1,9 are equal to 0,1-8,9, for example)
+                bool is_duplicate = false;
+
+                for (Terms::iterator pt_it = primeTerms.begin(); 
+                    pt_it < primeTerms.end(); ++pt_it) 
+                {
+                    if ((*pt_it)->getExpression() == (*it)->getExpression()) {
+                        is_duplicate = true;
+                        break;
+                    }
+                }
+
+                if (!is_duplicate) {
+                    primeTerms.push_back(*it);
+                }
+            }
+        }
+
+        currentTerms = nextTerms;
+
+        // the queue, currentTerms and primeTerms are all the state there is
+        if (checkpoint && checkpoint->isDue()) {
+            checkpoint->saveCombine(termsQueue, currentTerms, primeTerms);
+        }
+    }
+}
+
+namespace {
+    uint64_t cube_key(unsigned int value, unsigned int dash_mask) {
+        return ((uint64_t)dash_mask << 32) | value;
+    }
+
+    /**
+     * Answers whether a cube lies entirely within the Dont-Care set: a cube
+     * does iff both halves along one of its dashes do.
+     */
+    class DontCareCubes {
+        public:
+            DontCareCubes(const Terms& terms) :
+                _minterms(),
+                _cubes()
+            {
+                for (Terms::const_iterator it = terms.begin(); it < terms.end(); ++it) {
+                    if ((*it)->isDontCare()) {
+                        _minterms.insert((*it)->getDecimal());
+                    }
+                }
+            }
+
+            bool contains(unsigned int value, unsigned int dash_mask) {
+                if (dash_mask == 0) {
+                    return _minterms.count(value) > 0;
+                }
+
+                uint64_t key = cube_key(value, dash_mask);
+                std::tr1::unordered_map<uint64_t, bool>::iterator position = _cubes.find(key);
+                if (position != _cubes.end()) {
+                    return position->second;
+                }
+
+                unsigned int bit = dash_mask & -dash_mask;
+                bool result = contains(value, dash_mask & ~bit) &&
+                              contains(value | bit, dash_mask & ~bit);
+                _cubes[key] = result;
+                return result;
+            }
+
+        private:
+            std::tr1::unordered_set<unsigned int> _minterms;
+            std::tr1::unordered_map<uint64_t, bool> _cubes;
+    };
+}
+
+void combine_on_terms(Terms& terms, Terms& primeTerms) {
+    if (terms.empty()) {
+        return;
+    }
+
+    size_t literals_count = terms.front()->getLiteralCount();
+    unsigned int all = (literals_count == 32) ? ~0u : ((1u << literals_count) - 1);
+    DontCareCubes dontCares(terms);
+
+    // ON implicants of the current level, by (dash mask, value)
+    std::tr1::unordered_map<uint64_t, Term*> current;
+    for (Terms::iterator it = terms.begin(); it < terms.end(); ++it) {
+        if (!(*it)->isDontCare()) {
+            current.insert(std::make_pair(cube_key((*it)->getDecimal(), 0), *it));
+        }
+    }
+
+    while (!current.empty()) {
+        std::tr1::unordered_map<uint64_t, Term*> next;
+        for (std::tr1::unordered_map<uint64_t, Term*>::iterator it = current.begin();
+             it != current.end(); ++it)
+        {
+            unsigned int dash_mask = it->first >> 32;
+            unsigned int value = it->first & 0xffffffffu;
+            bool merged = false;
+
+            // an implicant of the next level that holds an ON minterm has a
+            // half holding one too, so walking up from the ON cubes only is
+            // complete as long as the other half may be Dont-Care only.
+            for (unsigned int bits = all & ~dash_mask; bits != 0; bits &= bits - 1) {
+                unsigned int bit = bits & -bits;
+                unsigned int neighbour = value ^ bit;
+                if (!current.count(cube_key(neighbour, dash_mask)) &&
+                    !dontCares.contains(neighbour, dash_mask))
+                {
+                    continue;
+                }
+
+                merged = true;
+                uint64_t key = cube_key(value & ~bit, dash_mask | bit);
+                if (!next.count(key)) {
+                    Term* term = new Term(value & ~bit, dash_mask | bit, literals_count);
+                    terms.push_back(term); // add to heap pointers vector
+                    next[key] = term;
+                }
+            }
+
+            if (!merged) {
+                primeTerms.push_back(it->second);
+            }
+        }
+
+        current.swap(next);
+    }
+}
+
+void combine_cube_terms(Terms& terms, Terms& primeTerms) {
+    if (terms.empty()) {
+        return;
+    }
+
+    size_t literals_count = terms.front()->getLiteralCount();
+    unsigned int all = (literals_count == 32) ? ~0u : ((1u << literals_count) - 1);
+    typedef std::tr1::unordered_map<uint64_t, Term*> Level;
+
+    // levels[k] holds the cubes with k dashes, by (dash mask, value)
+    std::vector<Level> levels(literals_count + 1);
+    for (Terms::iterator it = terms.begin(); it < terms.end(); ++it) {
+        unsigned int dash_mask = (*it)->getDashMask();
+        Level& level = levels[__builtin_popcount(dash_mask)];
+        uint64_t key = cube_key((*it)->getDecimal() & ~dash_mask, dash_mask);
+        Level::iterator position = level.find(key);
+        if (position == level.end() || (position->second->isDontCare() && !(*it)->isDontCare())) {
+            level[key] = *it;
+        }
+    }
+
+    Terms seeds;
+    for (size_t k = 0; k <= literals_count; ++k) {
+        Level& current = levels[k];
+        for (Level::iterator it = current.begin(); it != current.end(); ++it) {
+            unsigned int dash_mask = it->first >> 32;
+            unsigned int value = it->first & 0xffffffffu;
+
+            // merge with the neighbour one 1 above; the one below merges
+            // with this cube from its own side
+            for (unsigned int bits = all & ~(dash_mask | value); bits != 0; bits &= bits - 1) {
+                unsigned int bit = bits & -bits;
+                Level::iterator neighbour = current.find(cube_key(value | bit, dash_mask));
+                if (neighbour == current.end()) {
+                    continue;
+                }
+
+                it->second->select();
+                neighbour->second->select();
+
+                bool dont_care = it->second->isDontCare() && neighbour->second->isDontCare();
+                uint64_t key = cube_key(value, dash_mask | bit);
+                Level::iterator position = levels[k + 1].find(key);
+                if (position != levels[k + 1].end() && (dont_care || !position->second->isDontCare())) {
+                    continue;
+                }
+
+                Term* term = new Term(value, dash_mask | bit, literals_count);
+                if (dont_care) {
+                    term->dontCare();
+                }
+
+                terms.push_back(term); // add to heap pointers vector
+                levels[k + 1][key] = term;
+            }
+
+            if (!it->second->isSelected()) {
+                seeds.push_back(it->second);
+            }
+        }
+    }
+
+    // consensus appends the cubes it creates to seeds; terms owns them
+    size_t seeds_count = seeds.size();
+    try {
+        consensus_terms(seeds, primeTerms);
+    } catch (...) {
+        terms.insert(terms.end(), seeds.begin() + seeds_count, seeds.end());
+        throw;
+    }
+
+    terms.insert(terms.end(), seeds.begin() + seeds_count, seeds.end());
+}
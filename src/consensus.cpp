@@ -0,0 +1,178 @@
+#include "../include/consensus.h"
+
+#include <tr1/unordered_map>
+
+namespace {
+    /**
+     * Cubes bucketed by dash mask and value. A cube is contained in another
+     * iff the other's dash mask is a superset of its own and the values agree
+     * outside of it, so a containment query is one hash lookup per distinct
+     * superset mask instead of a scan over every cube.
+     */
+    class CubeIndex {
+        public:
+            CubeIndex() :
+                _buckets(),
+                _masks()
+            {
+            }
+
+            bool contains(unsigned int value, unsigned int dash_mask) const {
+                for (std::vector<unsigned int>::const_iterator it = _masks.begin();
+                     it < _masks.end(); ++it)
+                {
+                    if ((*it & dash_mask) != dash_mask) {
+                        continue;
+                    }
+
+                    const Bucket& bucket = _buckets.find(*it)->second;
+                    if (bucket.count(value & ~*it)) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            // removes the cubes contained in (value, dash_mask), returning their ids
+            void absorb(unsigned int value, unsigned int dash_mask, std::vector<size_t>& absorbed) {
+                for (std::vector<unsigned int>::const_iterator it = _masks.begin();
+                     it < _masks.end(); ++it)
+                {
+                    if ((*it & dash_mask) != *it) {
+                        continue;
+                    }
+
+                    Bucket& bucket = _buckets[*it];
+                    for (Bucket::iterator b_it = bucket.begin(); b_it != bucket.end(); ) {
+                        if ((b_it->first & ~dash_mask) == value) {
+                            absorbed.push_back(b_it->second);
+                            b_it = bucket.erase(b_it);
+                        } else {
+                            ++b_it;
+                        }
+                    }
+                }
+            }
+
+            void insert(unsigned int value, unsigned int dash_mask, size_t id) {
+                Buckets::iterator position = _buckets.find(dash_mask);
+                if (position == _buckets.end()) {
+                    _masks.push_back(dash_mask);
+                    position = _buckets.insert(std::make_pair(dash_mask, Bucket())).first;
+                }
+
+                position->second[value] = id;
+            }
+
+        private:
+            typedef std::tr1::unordered_map<unsigned int, size_t> Bucket;
+            typedef std::tr1::unordered_map<unsigned int, Bucket> Buckets;
+
+            Buckets _buckets;
+            std::vector<unsigned int> _masks;
+    };
+
+    struct ConsensusState {
+        ConsensusState(size_t literals) :
+            literals_count(literals),
+            index(),
+            cubes(),
+            values(),
+            masks(),
+            alive(),
+            worklist()
+        {
+        }
+
+        // adds the cube unless it is already contained, absorbing what it contains
+        void add(Term* term, unsigned int value, unsigned int dash_mask) {
+            if (index.contains(value, dash_mask)) {
+                return;
+            }
+
+            std::vector<size_t> absorbed;
+            index.absorb(value, dash_mask, absorbed);
+            for (std::vector<size_t>::iterator it = absorbed.begin(); it < absorbed.end(); ++it) {
+                alive[*it] = false;
+            }
+
+            size_t id = cubes.size();
+            cubes.push_back(term);
+            values.push_back(value);
+            masks.push_back(dash_mask);
+            alive.push_back(true);
+            worklist.push_back(id);
+            index.insert(value, dash_mask, id);
+        }
+
+        size_t literals_count;
+        CubeIndex index;
+        Terms cubes;
+        std::vector<unsigned int> values;
+        std::vector<unsigned int> masks;
+        std::vector<bool> alive;
+        std::vector<size_t> worklist;
+    };
+}
+
+void consensus_terms(Terms& terms, Terms& primeTerms) {
+    if (terms.empty()) {
+        return;
+    }
+
+    ConsensusState state(terms.at(0)->getLiteralCount());
+
+    Terms onTerms;
+    for (Terms::iterator it = terms.begin(); it < terms.end(); ++it) {
+        unsigned int dash_mask = (*it)->getDashMask();
+        state.add(*it, (*it)->getDecimal() & ~dash_mask, dash_mask);
+        if (!(*it)->isDontCare()) {
+            onTerms.push_back(*it);
+        }
+    }
+
+    while (!state.worklist.empty()) {
+        size_t current = state.worklist.back();
+        state.worklist.pop_back();
+
+        for (size_t other = 0; other < state.cubes.size() && state.alive[current]; ++other) {
+            if (other == current || !state.alive[other]) {
+                continue;
+            }
+
+            // the consensus exists iff the cubes clash in exactly one variable
+            unsigned int clash = (state.values[current] ^ state.values[other])
+                                 & ~(state.masks[current] | state.masks[other]);
+            if (clash == 0 || (clash & (clash - 1)) != 0) {
+                continue;
+            }
+
+            unsigned int dash_mask = (state.masks[current] & state.masks[other]) | clash;
+            unsigned int value = (state.values[current] | state.values[other]) & ~dash_mask;
+            if (state.index.contains(value, dash_mask)) {
+                continue;
+            }
+
+            Term* term = new Term(value, dash_mask, state.literals_count);
+            terms.push_back(term); // add to heap pointers vector
+            state.add(term, value, dash_mask);
+        }
+    }
+
+    // the surviving cubes are the primes; keep the ones touching the ON-set
+    for (size_t i = 0; i < state.cubes.size(); ++i) {
+        if (!state.alive[i]) {
+            continue;
+        }
+
+        for (Terms::iterator it = onTerms.begin(); it < onTerms.end(); ++it) {
+            unsigned int dash_mask = (*it)->getDashMask();
+            unsigned int value = (*it)->getDecimal() & ~dash_mask;
+            if (((value ^ state.values[i]) & ~(dash_mask | state.masks[i])) == 0) {
+                primeTerms.push_back(state.cubes[i]);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,883 @@
+#include "../include/cover.h"
+#include "../include/checkpoint.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <tr1/unordered_map>
+
+typedef std::tr1::unordered_map<size_t, Terms> ImplicantsMap;
+
+Terms select_cover(Terms& primeTerms, const Terms& dontCareTerms) {
+    Terms primeImplicants;
+    ImplicantsMap implicantsMap;
+    for (Terms::iterator it = primeTerms.begin(); 
+        it < primeTerms.end(); ++it) 
+    {
+        Term* term = *it;
+        term->primeImplicantCandidate();
+        std::vector<size_t> minterms = term->getMinterms();
+        for (std::vector<size_t>::iterator mt_it = minterms.begin();
+             mt_it < minterms.end(); ++mt_it)
+        {
+            implicantsMap[*mt_it].push_back(term);
+        }
+    }
+
+    // remove dontcare minterms from implicantsMap, as we don't need to
+    // actually cover them.
+    for (Terms::const_iterator it = dontCareTerms.begin();
+         it < dontCareTerms.end(); ++it)
+    {
+        std::vector<size_t>& minterms = (*it)->getMinterms();
+        for (std::vector<size_t>::iterator mt_it = minterms.begin();
+             mt_it < minterms.end(); ++mt_it)
+        {
+            size_t minterm = *mt_it;
+            for (Terms::iterator t_it = implicantsMap[minterm].begin();
+                 t_it < implicantsMap[minterm].end(); ++t_it)
+            {
+                (*t_it)->coverMinterm(minterm);
+            }
+
+            implicantsMap[minterm].clear();
+        }
+    }
+
+
+    for (ImplicantsMap::iterator main_it = implicantsMap.begin();
+         main_it != implicantsMap.end(); ++main_it)
+    {
+        // find minterms that are only covered by one implicant, and remove any
+        // term from the map that cover the minterms that implicant does.
+        bool found_prime_implicant = false;
+        for (ImplicantsMap::iterator it = implicantsMap.begin();
+             it != implicantsMap.end(); ++it)
+        {
+            if ((*it).second.size() == 1) {
+                Term* term = (*it).second.at(0);
+                
+                // we found a new prime implicant!
+//                std::cout << "New (natural) prime implicant for term " << (*it).first << "! " << term->getExpression() <<
+//                        " (" << term->getDecimals() << ")" << std::endl;
+//                std::cout << (*it).second << std::endl;
+
+                term->primeImplicant();
+                found_prime_implicant = true;
+
+                primeImplicants.push_back(term);
+                std::vector<size_t> minterms = term->getMinterms();
+                for (std::vector<size_t>::iterator mt_it = minterms.begin();
+                     mt_it < minterms.end(); ++mt_it)
+                {
+                    for (Terms::iterator t_it = implicantsMap[*mt_it].begin();
+                         t_it < implicantsMap[*mt_it].end(); ++t_it)
+                    {
+                        (*t_it)->coverMinterm(*mt_it);
+                    }
+
+                    implicantsMap[*mt_it].clear();
+                }
+            }
+        }
+
+        if (!found_prime_implicant) {
+            // choose an arbitrary implicant to be a prime implicant
+            // -- we are choosing the first term we can find that appears the most
+            std::sort(primeTerms.begin(), 
+                      primeTerms.end(), 
+                      Term::PrimeImplicantCandidatesCompare());
+
+            // find the first non-prime implicant term
+            Term* term = 0;
+            for (Terms::iterator pt_it = primeTerms.begin();
+                 pt_it < primeTerms.end(); ++pt_it)
+            {
+                if (!(*pt_it)->isPrimeImplicant() 
+                    && (*pt_it)->getRemainingMinterms().size() > 0) 
+                {
+                    term = *pt_it;
+                    break;
+                }
+            }
+            
+            if (term == 0) {
+                // we don't have any more prime terms! we are done.
+                break;
+            }
+
+            // we found a new prime implicant!
+//            std::cout << "New prime implicant! " << term->getExpression() <<
+//                    " (" << term->getDecimals() << ")" << std::endl;
+            term->primeImplicant();
+            primeImplicants.push_back(term);
+
+            std::vector<size_t> minterms = term->getMinterms();
+            for (std::vector<size_t>::iterator mt_it = minterms.begin();
+                 mt_it < minterms.end(); ++mt_it)
+            {
+                for (Terms::iterator t_it = implicantsMap[*mt_it].begin();
+                     t_it < implicantsMap[*mt_it].end(); ++t_it)
+                {
+                    (*t_it)->coverMinterm(*mt_it);
+                }
+
+                implicantsMap[*mt_it].clear();
+            }
+        }
+    }
+
+    return primeImplicants;
+}
+
+CoverChart::CoverChart(const Terms& dontCareTerms) :
+    _primes(),
+    _rows(),
+    _columns(),
+    _row_indices(),
+    _column_indices(),
+    _dont_cares(),
+    _on_values(),
+    _on_rows(false)
+{
+    for (Terms::const_iterator it = dontCareTerms.begin();
+         it < dontCareTerms.end(); ++it)
+    {
+        std::vector<size_t>& minterms = (*it)->getMinterms();
+        _dont_cares.insert(minterms.begin(), minterms.end());
+    }
+}
+
+CoverChart::CoverChart(const std::vector<unsigned int>& onValues) :
+    _primes(),
+    _rows(onValues.size()),
+    _columns(),
+    _row_indices(),
+    _column_indices(),
+    _dont_cares(),
+    _on_values(onValues),
+    _on_rows(true)
+{
+}
+
+CoverChart::~CoverChart() {
+}
+
+void CoverChart::addPrime(Term* term) {
+    size_t column = _columns.size();
+    _primes.push_back(term);
+    _columns.push_back(std::vector<size_t>());
+    _column_indices[term] = column;
+
+    if (_on_rows) {
+        unsigned int dash_mask = term->getDashMask();
+        unsigned int value = term->getDecimal() & ~dash_mask;
+        for (size_t row = 0; row < _on_values.size(); ++row) {
+            if ((_on_values[row] & ~dash_mask) == value) {
+                _rows[row].push_back(column);
+                _columns[column].push_back(row);
+            }
+        }
+
+        return;
+    }
+
+    std::vector<size_t>& minterms = term->getMinterms();
+    for (std::vector<size_t>::iterator it = minterms.begin();
+         it < minterms.end(); ++it)
+    {
+        if (_dont_cares.count(*it)) {
+            continue;
+        }
+
+        std::tr1::unordered_map<size_t, size_t>::iterator position = _row_indices.find(*it);
+        size_t row;
+        if (position == _row_indices.end()) {
+            row = _rows.size();
+            _row_indices[*it] = row;
+            _rows.push_back(std::vector<size_t>());
+        } else {
+            row = position->second;
+        }
+
+        _rows[row].push_back(column);
+        _columns[column].push_back(row);
+    }
+}
+
+size_t CoverChart::getRowsCount() const {
+    return _rows.size();
+}
+
+size_t CoverChart::getColumnsCount() const {
+    return _columns.size();
+}
+
+const std::vector<size_t>& CoverChart::getRow(size_t row) const {
+    return _rows[row];
+}
+
+const std::vector<size_t>& CoverChart::getColumn(size_t column) const {
+    return _columns[column];
+}
+
+Term* CoverChart::getPrime(size_t column) const {
+    return _primes[column];
+}
+
+int CoverChart::getColumnIndex(const Term* term) const {
+    std::tr1::unordered_map<const Term*, size_t>::const_iterator position = _column_indices.find(term);
+    if (position == _column_indices.end()) {
+        return -1;
+    }
+
+    return position->second;
+}
+
+namespace {
+    // the chart's primes to the checkpoint, with cover (columns) as the best cover so far
+    void save_search(Checkpoint* checkpoint, const CoverChart& chart, const std::vector<size_t>& cover) {
+        Terms primeTerms;
+        for (size_t column = 0; column < chart.getColumnsCount(); ++column) {
+            primeTerms.push_back(chart.getPrime(column));
+        }
+
+        Terms coverTerms;
+        for (std::vector<size_t>::const_iterator it = cover.begin(); it < cover.end(); ++it) {
+            coverTerms.push_back(chart.getPrime(*it));
+        }
+
+        checkpoint->saveSearch(primeTerms, coverTerms);
+    }
+
+    /**
+     * The best cover the workers of a portfolio have found so far, whose
+     * cost bounds all of them, and whether one has proven it optimal. With
+     * a checkpoint, every better cover is saved there.
+     */
+    class SharedCover {
+        public:
+            SharedCover(const CoverChart& chart, const std::vector<size_t>& seed, Checkpoint* checkpoint) :
+                _chart(chart),
+                _checkpoint(checkpoint),
+                _cost(seed.size()),
+                _done(false),
+                _mutex(),
+                _best(seed)
+            {
+            }
+
+            size_t getCost() const {
+                return _cost;
+            }
+
+            std::vector<size_t> getBest() {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _best;
+            }
+
+            void offer(const std::vector<size_t>& cover) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (cover.size() < _best.size()) {
+                    _best = cover;
+                    _cost = cover.size();
+                    if (_checkpoint) {
+                        save_search(_checkpoint, _chart, _best);
+                    }
+                }
+            }
+
+            bool isDone() const {
+                return _done;
+            }
+
+            void finish() {
+                _done = true;
+            }
+
+        private:
+            SharedCover(const SharedCover&);
+
+            SharedCover& operator=(const SharedCover&);
+
+            const CoverChart& _chart;
+            Checkpoint* _checkpoint;
+            std::atomic<size_t> _cost;
+            std::atomic<bool> _done;
+            std::mutex _mutex;
+            std::vector<size_t> _best;
+    };
+
+    /**
+     * Depth first branch and bound over the chart. Branches on the uncovered
+     * row with the fewest candidate columns and prunes with an independent
+     * rows bound (rows sharing no column need distinct primes). In a
+     * portfolio, the shared cover bounds it too, and a nonzero seed breaks
+     * the ties between equally good columns at random. Alone, it saves every
+     * better cover to the checkpoint, if any.
+     */
+    class CoverSearch {
+        public:
+            CoverSearch(const CoverChart& chart, const Deadline& deadline,
+                        SharedCover* shared = 0, unsigned int seed = 0, Checkpoint* checkpoint = 0) :
+                _chart(chart),
+                _deadline(deadline),
+                _shared(shared),
+                _checkpoint(checkpoint),
+                _random(seed),
+                _seed(seed),
+                _covered(chart.getRowsCount(), 0),
+                _rows_order(),
+                _chosen(),
+                _best(),
+                _aborted(false),
+                _nodes(0)
+            {
+                for (size_t row = 0; row < chart.getRowsCount(); ++row) {
+                    _rows_order.push_back(row);
+                }
+
+                std::sort(_rows_order.begin(), _rows_order.end(), RowSizeCompare(chart));
+            }
+
+            // returns true when the search space was exhausted, i.e. best is optimal
+            bool run(std::vector<size_t>& best) {
+                _best = best;
+                search(_chart.getRowsCount());
+                best = _best;
+                return !_aborted;
+            }
+
+            size_t lowerBound() const {
+                std::vector<char> blocked(_chart.getColumnsCount(), 0);
+                size_t bound = 0;
+                for (std::vector<size_t>::const_iterator it = _rows_order.begin();
+                     it < _rows_order.end(); ++it)
+                {
+                    if (_covered[*it] > 0) {
+                        continue;
+                    }
+
+                    const std::vector<size_t>& columns = _chart.getRow(*it);
+                    bool independent = true;
+                    for (std::vector<size_t>::const_iterator c_it = columns.begin();
+                         c_it < columns.end(); ++c_it)
+                    {
+                        if (blocked[*c_it]) {
+                            independent = false;
+                            break;
+                        }
+                    }
+
+                    if (independent) {
+                        bound++;
+                        for (std::vector<size_t>::const_iterator c_it = columns.begin();
+                             c_it < columns.end(); ++c_it)
+                        {
+                            blocked[*c_it] = 1;
+                        }
+                    }
+                }
+
+                return bound;
+            }
+
+        private:
+            struct RowSizeCompare {
+                RowSizeCompare(const CoverChart& chart) : _chart(chart) {
+                }
+
+                bool operator()(size_t left, size_t right) const {
+                    return _chart.getRow(left).size() < _chart.getRow(right).size();
+                }
+
+                const CoverChart& _chart;
+            };
+
+            struct GainCompare {
+                bool operator()(const std::pair<size_t, size_t>& left,
+                                const std::pair<size_t, size_t>& right) const
+                {
+                    return left.first > right.first;
+                }
+            };
+
+            CoverSearch(const CoverSearch&);
+
+            CoverSearch& operator=(const CoverSearch&);
+
+            size_t bestCost() const {
+                return _shared ? std::min(_best.size(), _shared->getCost()) : _best.size();
+            }
+
+            void search(size_t uncovered) {
+                if (_aborted) {
+                    return;
+                }
+
+                if ((++_nodes & 255) == 0 && (_deadline.expired() || (_shared && _shared->isDone()))) {
+                    _aborted = true;
+                    return;
+                }
+
+                if (uncovered == 0) {
+                    if (_chosen.size() < bestCost()) {
+                        _best = _chosen;
+                        if (_shared) {
+                            _shared->offer(_best);
+                        } else if (_checkpoint) {
+                            save_search(_checkpoint, _chart, _best);
+                        }
+                    }
+
+                    return;
+                }
+
+                if (_chosen.size() + lowerBound() >= bestCost()) {
+                    return;
+                }
+
+                // branch on the hardest uncovered row
+                size_t branch_row = 0;
+                size_t branch_size = 0;
+                for (size_t row = 0; row < _covered.size(); ++row) {
+                    if (_covered[row] == 0 &&
+                        (branch_size == 0 || _chart.getRow(row).size() < branch_size))
+                    {
+                        branch_row = row;
+                        branch_size = _chart.getRow(row).size();
+                    }
+                }
+
+                // try the columns covering the most uncovered rows first
+                std::vector<std::pair<size_t, size_t> > candidates;
+                const std::vector<size_t>& columns = _chart.getRow(branch_row);
+                for (std::vector<size_t>::const_iterator it = columns.begin();
+                     it < columns.end(); ++it)
+                {
+                    size_t gain = 0;
+                    const std::vector<size_t>& rows = _chart.getColumn(*it);
+                    for (std::vector<size_t>::const_iterator r_it = rows.begin();
+                         r_it < rows.end(); ++r_it)
+                    {
+                        if (_covered[*r_it] == 0) {
+                            gain++;
+                        }
+                    }
+
+                    candidates.push_back(std::make_pair(gain, *it));
+                }
+
+                if (_seed != 0) {
+                    std::shuffle(candidates.begin(), candidates.end(), _random);
+                }
+
+                std::stable_sort(candidates.begin(), candidates.end(), GainCompare());
+
+                for (std::vector<std::pair<size_t, size_t> >::iterator it = candidates.begin();
+                     it < candidates.end(); ++it)
+                {
+                    const std::vector<size_t>& rows = _chart.getColumn(it->second);
+                    for (std::vector<size_t>::const_iterator r_it = rows.begin();
+                         r_it < rows.end(); ++r_it)
+                    {
+                        _covered[*r_it]++;
+                    }
+
+                    _chosen.push_back(it->second);
+                    search(uncovered - it->first);
+                    _chosen.pop_back();
+
+                    for (std::vector<size_t>::const_iterator r_it = rows.begin();
+                         r_it < rows.end(); ++r_it)
+                    {
+                        _covered[*r_it]--;
+                    }
+
+                    if (_aborted) {
+                        return;
+                    }
+                }
+            }
+
+            const CoverChart& _chart;
+            const Deadline& _deadline;
+            SharedCover* _shared;
+            Checkpoint* _checkpoint;
+            std::minstd_rand _random;
+            unsigned int _seed;
+            std::vector<int> _covered;
+            std::vector<size_t> _rows_order;
+            std::vector<size_t> _chosen;
+            std::vector<size_t> _best;
+            bool _aborted;
+            size_t _nodes;
+    };
+
+    /**
+     * Local search for a portfolio: takes the shared best cover, drops a few
+     * random columns, covers the rows left uncovered greedily (a random
+     * uncovered row at a time, by its column with the most uncovered rows)
+     * and removes the columns that became redundant. Smaller covers are
+     * offered to the shared cover, until the deadline or until a search
+     * proves it optimal.
+     */
+    class CoverLocalSearch {
+        public:
+            CoverLocalSearch(const CoverChart& chart, const Deadline& deadline,
+                             SharedCover& shared, unsigned int seed) :
+                _chart(chart),
+                _deadline(deadline),
+                _shared(shared),
+                _random(seed)
+            {
+            }
+
+            void run() {
+                std::vector<int> covered(_chart.getRowsCount());
+                while (!_deadline.expired() && !_shared.isDone()) {
+                    std::vector<size_t> cover = _shared.getBest();
+                    if (cover.empty()) {
+                        return;
+                    }
+
+                    size_t drops = 1 + _random() % std::min<size_t>(3, cover.size());
+                    for (size_t i = 0; i < drops; ++i) {
+                        std::swap(cover[_random() % cover.size()], cover.back());
+                        cover.pop_back();
+                    }
+
+                    std::fill(covered.begin(), covered.end(), 0);
+                    for (std::vector<size_t>::iterator it = cover.begin(); it < cover.end(); ++it) {
+                        add(*it, covered, 1);
+                    }
+
+                    repair(cover, covered);
+                    prune(cover, covered);
+                    if (cover.size() < _shared.getCost()) {
+                        _shared.offer(cover);
+                    }
+                }
+            }
+
+        private:
+            CoverLocalSearch(const CoverLocalSearch&);
+
+            CoverLocalSearch& operator=(const CoverLocalSearch&);
+
+            void add(size_t column, std::vector<int>& covered, int count) {
+                const std::vector<size_t>& rows = _chart.getColumn(column);
+                for (std::vector<size_t>::const_iterator it = rows.begin(); it < rows.end(); ++it) {
+                    covered[*it] += count;
+                }
+            }
+
+            void repair(std::vector<size_t>& cover, std::vector<int>& covered) {
+                std::vector<size_t> uncovered;
+                for (size_t row = 0; row < covered.size(); ++row) {
+                    if (covered[row] == 0) {
+                        uncovered.push_back(row);
+                    }
+                }
+
+                while (!uncovered.empty()) {
+                    size_t index = _random() % uncovered.size();
+                    size_t row = uncovered[index];
+                    std::swap(uncovered[index], uncovered.back());
+                    uncovered.pop_back();
+                    if (covered[row] > 0) {
+                        continue;
+                    }
+
+                    size_t best_column = 0;
+                    size_t best_gain = 0;
+                    const std::vector<size_t>& columns = _chart.getRow(row);
+                    for (std::vector<size_t>::const_iterator it = columns.begin(); it < columns.end(); ++it) {
+                        size_t gain = 0;
+                        const std::vector<size_t>& rows = _chart.getColumn(*it);
+                        for (std::vector<size_t>::const_iterator r_it = rows.begin(); r_it < rows.end(); ++r_it) {
+                            if (covered[*r_it] == 0) {
+                                gain++;
+                            }
+                        }
+
+                        if (gain > best_gain || (gain == best_gain && _random() % 2 == 0)) {
+                            best_column = *it;
+                            best_gain = gain;
+                        }
+                    }
+
+                    cover.push_back(best_column);
+                    add(best_column, covered, 1);
+                }
+            }
+
+            // in random order, drops the columns whose rows are all covered twice
+            void prune(std::vector<size_t>& cover, std::vector<int>& covered) {
+                std::shuffle(cover.begin(), cover.end(), _random);
+                for (size_t i = 0; i < cover.size(); ) {
+                    const std::vector<size_t>& rows = _chart.getColumn(cover[i]);
+                    bool redundant = true;
+                    for (std::vector<size_t>::const_iterator it = rows.begin(); it < rows.end(); ++it) {
+                        if (covered[*it] < 2) {
+                            redundant = false;
+                            break;
+                        }
+                    }
+
+                    if (redundant) {
+                        add(cover[i], covered, -1);
+                        cover[i] = cover.back();
+                        cover.pop_back();
+                    } else {
+                        ++i;
+                    }
+                }
+            }
+
+            const CoverChart& _chart;
+            const Deadline& _deadline;
+            SharedCover& _shared;
+            std::minstd_rand _random;
+    };
+
+    /**
+     * One worker of a portfolio: even workers run the branch and bound (the
+     * first one in search_chart_cover()'s order), odd ones the local search.
+     * A branch and bound that completes proves the shared cover optimal.
+     */
+    class PortfolioWorker {
+        public:
+            PortfolioWorker(const CoverChart& chart, const Deadline& deadline, SharedCover& shared,
+                            size_t index, std::exception_ptr& error, std::mutex& mutex) :
+                _chart(chart),
+                _deadline(deadline),
+                _shared(shared),
+                _index(index),
+                _error(error),
+                _mutex(mutex)
+            {
+            }
+
+            void operator()() {
+                try {
+                    unsigned int seed = _index + 1;
+                    if (_index % 2 == 1) {
+                        CoverLocalSearch search(_chart, _deadline, _shared, seed);
+                        search.run();
+                        return;
+                    }
+
+                    CoverSearch search(_chart, _deadline, &_shared, _index == 0 ? 0 : seed);
+                    std::vector<size_t> best = _shared.getBest();
+                    if (search.run(best)) {
+                        _shared.finish();
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_error) {
+                        _error = std::current_exception();
+                    }
+
+                    _shared.finish();
+                }
+            }
+
+        private:
+            const CoverChart& _chart;
+            const Deadline& _deadline;
+            SharedCover& _shared;
+            size_t _index;
+            std::exception_ptr& _error;
+            std::mutex& _mutex;
+    };
+
+    /**
+     * The cover the search starts from: the greedy one, or the best cover of a
+     * SEARCH checkpoint being resumed when that is smaller.
+     */
+    Terms resumed_seed(Terms& primeTerms, const Terms& dontCareTerms, const Checkpoint* checkpoint) {
+        // before select_cover(), which reorders the primes
+        Terms resumed;
+        if (checkpoint && checkpoint->getPhase() == Checkpoint::SEARCH) {
+            checkpoint->restoreSearch(primeTerms, resumed);
+        }
+
+        // the greedy cover is the first valid answer we can hand out
+        Terms seed = select_cover(primeTerms, dontCareTerms);
+        if (!resumed.empty() && resumed.size() < seed.size()) {
+            seed = resumed;
+        }
+
+        return seed;
+    }
+}
+
+Terms chart_cover(const CoverChart& chart) {
+    std::vector<char> covered(chart.getRowsCount(), 0);
+    std::vector<char> chosen(chart.getColumnsCount(), 0);
+    size_t uncovered = chart.getRowsCount();
+    Terms cover;
+
+    // rows with a single column make that column essential
+    for (size_t row = 0; row < chart.getRowsCount(); ++row) {
+        if (chart.getRow(row).size() == 1) {
+            chosen[chart.getRow(row)[0]] = 1;
+        }
+    }
+
+    for (size_t column = 0; column < chart.getColumnsCount(); ++column) {
+        if (!chosen[column]) {
+            continue;
+        }
+
+        cover.push_back(chart.getPrime(column));
+        const std::vector<size_t>& rows = chart.getColumn(column);
+        for (std::vector<size_t>::const_iterator it = rows.begin();
+             it < rows.end(); ++it)
+        {
+            if (!covered[*it]) {
+                covered[*it] = 1;
+                uncovered--;
+            }
+        }
+    }
+
+    while (uncovered > 0) {
+        size_t best_column = 0;
+        size_t best_gain = 0;
+        for (size_t column = 0; column < chart.getColumnsCount(); ++column) {
+            if (chosen[column]) {
+                continue;
+            }
+
+            size_t gain = 0;
+            const std::vector<size_t>& rows = chart.getColumn(column);
+            for (std::vector<size_t>::const_iterator it = rows.begin();
+                 it < rows.end(); ++it)
+            {
+                if (!covered[*it]) {
+                    gain++;
+                }
+            }
+
+            if (gain > best_gain) {
+                best_column = column;
+                best_gain = gain;
+            }
+        }
+
+        chosen[best_column] = 1;
+        cover.push_back(chart.getPrime(best_column));
+        const std::vector<size_t>& rows = chart.getColumn(best_column);
+        for (std::vector<size_t>::const_iterator it = rows.begin();
+             it < rows.end(); ++it)
+        {
+            if (!covered[*it]) {
+                covered[*it] = 1;
+                uncovered--;
+            }
+        }
+    }
+
+    return cover;
+}
+
+CoverResult search_chart_cover(const CoverChart& chart, const Terms& seed, const Deadline& deadline,
+                               Checkpoint* checkpoint)
+{
+    std::vector<size_t> best;
+    for (Terms::const_iterator it = seed.begin(); it < seed.end(); ++it) {
+        best.push_back(chart.getColumnIndex(*it));
+    }
+
+    CoverSearch search(chart, deadline, 0, 0, checkpoint);
+
+    CoverResult result;
+    result.lower_bound = search.lowerBound();
+    result.optimal = search.run(best);
+
+    for (std::vector<size_t>::iterator it = best.begin(); it < best.end(); ++it) {
+        result.cover.push_back(chart.getPrime(*it));
+    }
+
+    result.cost = result.cover.size();
+    if (result.optimal) {
+        result.lower_bound = result.cost;
+    }
+
+    return result;
+}
+
+CoverResult portfolio_chart_cover(const CoverChart& chart, const Terms& seed, const Deadline& deadline,
+                                  size_t threads_count, Checkpoint* checkpoint)
+{
+    std::vector<size_t> best;
+    for (Terms::const_iterator it = seed.begin(); it < seed.end(); ++it) {
+        best.push_back(chart.getColumnIndex(*it));
+    }
+
+    SharedCover shared(chart, best, checkpoint);
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads_count; ++i) {
+        workers.push_back(std::thread(PortfolioWorker(chart, deadline, shared, i, error, mutex)));
+    }
+
+    PortfolioWorker(chart, deadline, shared, 0, error, mutex)();
+    for (std::vector<std::thread>::iterator it = workers.begin(); it < workers.end(); ++it) {
+        it->join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+
+    CoverResult result;
+    result.lower_bound = CoverSearch(chart, deadline).lowerBound();
+    result.optimal = shared.isDone();
+
+    best = shared.getBest();
+    for (std::vector<size_t>::iterator it = best.begin(); it < best.end(); ++it) {
+        result.cover.push_back(chart.getPrime(*it));
+    }
+
+    result.cost = result.cover.size();
+    if (result.optimal) {
+        result.lower_bound = result.cost;
+    }
+
+    return result;
+}
+
+CoverResult portfolio_cover(Terms& primeTerms, const Terms& dontCareTerms, const Deadline& deadline,
+                            size_t threads_count, Checkpoint* checkpoint)
+{
+    CoverChart chart(dontCareTerms);
+    for (Terms::iterator it = primeTerms.begin();
+         it < primeTerms.end(); ++it)
+    {
+        chart.addPrime(*it);
+    }
+
+    Terms seed = resumed_seed(primeTerms, dontCareTerms, checkpoint);
+    return portfolio_chart_cover(chart, seed, deadline, threads_count, checkpoint);
+}
+
+CoverResult search_cover(Terms& primeTerms, const Terms& dontCareTerms, const Deadline& deadline,
+                         Checkpoint* checkpoint)
+{
+    CoverChart chart(dontCareTerms);
+    for (Terms::iterator it = primeTerms.begin();
+         it < primeTerms.end(); ++it)
+    {
+        chart.addPrime(*it);
+    }
+
+    Terms seed = resumed_seed(primeTerms, dontCareTerms, checkpoint);
+    return search_chart_cover(chart, seed, deadline, checkpoint);
+}
@@ -0,0 +1,164 @@
+#include "../include/cover_evaluator.h"
+
+namespace {
+    const size_t SLICE_WORDS = CoverEvaluator::SLICE_BITS / 64;
+
+    // bit j of PLANE_PATTERNS[i] is bit i of j
+    const uint64_t PLANE_PATTERNS[6] = {
+        0xaaaaaaaaaaaaaaaaULL,
+        0xccccccccccccccccULL,
+        0xf0f0f0f0f0f0f0f0ULL,
+        0xff00ff00ff00ff00ULL,
+        0xffff0000ffff0000ULL,
+        0xffffffff00000000ULL
+    };
+
+    void splat(CoverEvaluator::Slice& slice, uint64_t word) {
+        for (size_t w = 0; w < SLICE_WORDS; ++w) {
+            slice[w] = word;
+        }
+    }
+}
+
+CoverEvaluator::CoverEvaluator(const std::vector<Cube>& cover, size_t literals_count) :
+    _cover(cover),
+    _literals(),
+    _cube_ends(),
+    _literals_count(literals_count)
+{
+    for (std::vector<Cube>::const_iterator it = cover.begin(); it < cover.end(); ++it) {
+        for (size_t variable = 0; variable < literals_count; ++variable) {
+            if (!(it->second & (1u << variable))) {
+                _literals.push_back(Literal(variable, (it->first >> variable) & 1));
+            }
+        }
+
+        _cube_ends.push_back(_literals.size());
+    }
+}
+
+CoverEvaluator::~CoverEvaluator() {
+}
+
+size_t CoverEvaluator::getLiteralsCount() const {
+    return _literals_count;
+}
+
+bool CoverEvaluator::evaluate(unsigned int input) const {
+    for (std::vector<Cube>::const_iterator it = _cover.begin(); it < _cover.end(); ++it) {
+        if ((input & ~it->second) == (it->first & ~it->second)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CoverEvaluator::evaluate(const Slice* planes, Slice& result) const {
+    splat(result, 0);
+    size_t begin = 0;
+    for (std::vector<size_t>::const_iterator it = _cube_ends.begin(); it < _cube_ends.end(); ++it) {
+        Slice product;
+        splat(product, ~(uint64_t)0);
+        for (size_t i = begin; i < *it; ++i) {
+            const Literal& literal = _literals[i];
+            product &= literal.positive ? planes[literal.variable] : ~planes[literal.variable];
+        }
+
+        result |= product;
+        begin = *it;
+    }
+}
+
+void CoverEvaluator::evaluateBlock(size_t block, Slice& result) const {
+    std::vector<Slice> planes(_literals_count);
+    fillPlanes(block, planes);
+    evaluate(planes.empty() ? 0 : &planes[0], result);
+}
+
+void CoverEvaluator::fillPlanes(size_t block, std::vector<Slice>& planes) const {
+    // the low 6 variables follow a fixed pattern inside every word, the
+    // next 2 select the word of the slice and the rest are constant
+    for (size_t variable = 0; variable < _literals_count; ++variable) {
+        if (variable < 6) {
+            splat(planes[variable], PLANE_PATTERNS[variable]);
+        } else if (variable < 8) {
+            for (size_t w = 0; w < SLICE_WORDS; ++w) {
+                planes[variable][w] = ((w >> (variable - 6)) & 1) ? ~(uint64_t)0 : 0;
+            }
+        } else {
+            splat(planes[variable], ((block >> (variable - 8)) & 1) ? ~(uint64_t)0 : 0);
+        }
+    }
+}
+
+bool CoverEvaluator::verify(const Bitmap& on_set, const Bitmap& dont_care_set, unsigned int& counterexample) const {
+    size_t inputs_count = (size_t)1 << _literals_count;
+    size_t blocks = (inputs_count + SLICE_BITS - 1) / SLICE_BITS;
+    const std::vector<uint64_t>& on_words = on_set.getWords();
+    const std::vector<uint64_t>& dont_care_words = dont_care_set.getWords();
+
+    // variables from 8 up pick the block, so a cube is one slice (the AND of
+    // its low literals) ORed into each block its high literals allow: the
+    // work follows the size of the cover rather than cubes times blocks
+    std::vector<Slice> planes(_literals_count);
+    fillPlanes(0, planes);
+
+    std::vector<Slice> values(blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        splat(values[block], 0);
+    }
+
+    size_t begin = 0;
+    for (size_t c = 0; c < _cover.size(); ++c) {
+        Slice product;
+        splat(product, ~(uint64_t)0);
+        for (size_t i = begin; i < _cube_ends[c]; ++i) {
+            const Literal& literal = _literals[i];
+            if (literal.variable < 8) {
+                product &= literal.positive ? planes[literal.variable] : ~planes[literal.variable];
+            }
+        }
+
+        begin = _cube_ends[c];
+
+        size_t high_mask = blocks - 1;
+        size_t high_dashes = (_cover[c].second >> 8) & high_mask;
+        size_t high_value = (_cover[c].first >> 8) & high_mask & ~high_dashes;
+        size_t subset = 0;
+        do {
+            values[high_value | subset] |= product;
+            subset = (subset - high_dashes) & high_dashes;
+        } while (subset != 0);
+    }
+
+    for (size_t block = 0; block < blocks; ++block) {
+        Slice on;
+        Slice dont_care;
+        Slice valid;
+        splat(on, 0);
+        splat(dont_care, 0);
+        splat(valid, 0);
+        for (size_t w = 0; w < SLICE_WORDS; ++w) {
+            size_t word = block * SLICE_WORDS + w;
+            if (word >= on_words.size()) {
+                break;
+            }
+
+            on[w] = on_words[word];
+            dont_care[w] = dont_care_words[word];
+            valid[w] = (inputs_count - word * 64 >= 64) ? ~(uint64_t)0
+                                                        : (((uint64_t)1 << (inputs_count - word * 64)) - 1);
+        }
+
+        Slice mismatch = (values[block] ^ on) & ~dont_care & valid;
+        for (size_t w = 0; w < SLICE_WORDS; ++w) {
+            if (mismatch[w] != 0) {
+                counterexample = block * SLICE_BITS + w * 64 + __builtin_ctzll(mismatch[w]);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,76 @@
+#include "../include/cover_table.h"
+
+#include <stdint.h>
+
+namespace {
+    const uint64_t COVER_TABLE[1 << 16] = {
+#include "../bin/cover_table.inc"
+    };
+
+    // an entry holds up to 8 cubes (the parity function needs all of them)
+    const size_t MAX_PRODUCTS = 8;
+    const unsigned int NO_CUBE = 0xff;
+
+    void entry_cost(uint64_t entry, size_t& products, size_t& literals) {
+        products = 0;
+        literals = 0;
+        for (size_t i = 0; i < MAX_PRODUCTS && (entry & 0xff) != NO_CUBE; ++i, entry >>= 8) {
+            products++;
+            literals += 4 - __builtin_popcount((entry >> 4) & 0xf);
+        }
+    }
+}
+
+Terms table_cover(const std::vector<unsigned int>& onValues,
+                  const std::vector<unsigned int>& dontCareValues,
+                  size_t literals_count)
+{
+    // a function of fewer literals is looked up as a 4 literal one that
+    // does not depend on the extra (most significant) literals, so none of
+    // its cover's cubes mention them
+    uint16_t on = 0;
+    uint16_t dont_care = 0;
+    for (unsigned int high = 0; high < (1u << 4); high += (1u << literals_count)) {
+        for (std::vector<unsigned int>::const_iterator it = onValues.begin();
+             it < onValues.end(); ++it)
+        {
+            on |= 1 << (high | *it);
+        }
+
+        for (std::vector<unsigned int>::const_iterator it = dontCareValues.begin();
+             it < dontCareValues.end(); ++it)
+        {
+            dont_care |= 1 << (high | *it);
+        }
+    }
+
+    dont_care &= ~on;
+
+    // walk every subset of the Dont-Cares for the cheapest completion
+    uint64_t best = COVER_TABLE[on];
+    size_t best_products;
+    size_t best_literals;
+    entry_cost(best, best_products, best_literals);
+
+    for (uint16_t subset = dont_care; subset != 0; subset = (subset - 1) & dont_care) {
+        uint64_t entry = COVER_TABLE[on | subset];
+        size_t products;
+        size_t literals;
+        entry_cost(entry, products, literals);
+        if (products < best_products || (products == best_products && literals < best_literals)) {
+            best = entry;
+            best_products = products;
+            best_literals = literals;
+        }
+    }
+
+    unsigned int all = (1u << literals_count) - 1;
+    Terms cover;
+    for (size_t i = 0; i < MAX_PRODUCTS && (best & 0xff) != NO_CUBE; ++i, best >>= 8) {
+        unsigned int value = best & 0xf;
+        unsigned int dash_mask = (best >> 4) & 0xf;
+        cover.push_back(new Term(value & all, dash_mask & all, literals_count));
+    }
+
+    return cover;
+}
@@ -0,0 +1,83 @@
+/**
+ * Build time generator for the 4 literal cover table (see cover_table.h).
+ *
+ * Every one of the 81 cubes over 4 literals covers a 16 bit truth table.
+ * A function whose minimal cover has k products is the union of a function
+ * whose minimal cover has k - 1 products and one more cube (dropping a cube
+ * of a minimal cover leaves a minimal cover of what remains), so a breadth
+ * first walk over the products count reaches every function first with its
+ * minimal count, keeping the fewest literals among the covers of that size.
+ *
+ * Prints one 64 bit entry per function: up to 8 cube bytes (value in the low
+ * nibble, dash mask in the high one), unused bytes being 0xff.
+*/
+
+#include <cstdio>
+#include <vector>
+#include <stdint.h>
+
+int main() {
+    const size_t FUNCTIONS_COUNT = 1 << 16;
+    const int UNREACHED = -1;
+
+    std::vector<unsigned int> cubes;
+    std::vector<uint16_t> cube_tables;
+    std::vector<int> cube_literals;
+    for (unsigned int dash_mask = 0; dash_mask < 16; ++dash_mask) {
+        for (unsigned int value = 0; value < 16; ++value) {
+            if (value & dash_mask) {
+                continue;
+            }
+
+            uint16_t table = 0;
+            for (unsigned int minterm = 0; minterm < 16; ++minterm) {
+                if ((minterm & ~dash_mask) == value) {
+                    table |= 1 << minterm;
+                }
+            }
+
+            cubes.push_back(value | (dash_mask << 4));
+            cube_tables.push_back(table);
+            cube_literals.push_back(4 - __builtin_popcount(dash_mask));
+        }
+    }
+
+    std::vector<int> products(FUNCTIONS_COUNT, UNREACHED);
+    std::vector<int> literals(FUNCTIONS_COUNT, 0);
+    std::vector<uint64_t> entries(FUNCTIONS_COUNT, ~(uint64_t)0);
+
+    products[0] = 0;
+    std::vector<uint16_t> frontier(1, 0);
+    for (int count = 1; !frontier.empty(); ++count) {
+        std::vector<uint16_t> next;
+        for (std::vector<uint16_t>::iterator it = frontier.begin(); it < frontier.end(); ++it) {
+            for (size_t c = 0; c < cubes.size(); ++c) {
+                uint16_t function = *it | cube_tables[c];
+                if (products[function] != UNREACHED && products[function] != count) {
+                    continue;
+                }
+
+                int function_literals = literals[*it] + cube_literals[c];
+                if (products[function] == UNREACHED) {
+                    products[function] = count;
+                    next.push_back(function);
+                } else if (function_literals >= literals[function]) {
+                    continue;
+                }
+
+                literals[function] = function_literals;
+                entries[function] = (entries[*it] << 8) | cubes[c];
+            }
+        }
+
+        frontier.swap(next);
+    }
+
+    std::printf("// generated by cover_table_generator, do not edit\n");
+    for (size_t function = 0; function < FUNCTIONS_COUNT; ++function) {
+        std::printf("0x%016llxULL,%s", (unsigned long long)entries[function],
+                    (function % 4 == 3) ? "\n" : " ");
+    }
+
+    return 0;
+}
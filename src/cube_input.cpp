@@ -0,0 +1,305 @@
+#include "../include/cube_input.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    std::string pla_error(size_t line_number, const std::string& message) {
+        std::stringstream error;
+        error << "pla line " << line_number << ": " << message;
+        return error.str();
+    }
+
+    typedef std::vector<Cube> Cover;
+
+    // larger cubes first: a cube can only be contained in one before it
+    struct DashCountCompare {
+        bool operator()(const Cube& first, const Cube& second) const {
+            return __builtin_popcount(first.second) > __builtin_popcount(second.second);
+        }
+    };
+
+    // drops the cubes contained in another one
+    void absorb(Cover& cover) {
+        std::stable_sort(cover.begin(), cover.end(), DashCountCompare());
+        Cover kept;
+        for (Cover::iterator it = cover.begin(); it < cover.end(); ++it) {
+            bool contained = false;
+            for (Cover::iterator other = kept.begin(); other < kept.end(); ++other) {
+                if ((it->second & ~other->second) == 0 && ((it->first ^ other->first) & ~other->second) == 0) {
+                    contained = true;
+                    break;
+                }
+            }
+
+            if (!contained) {
+                kept.push_back(*it);
+            }
+        }
+
+        cover.swap(kept);
+    }
+
+    // the product of two covers: the pairwise intersections of their cubes
+    Cover conjoin(const Cover& first, const Cover& second) {
+        Cover product;
+        for (Cover::const_iterator it = first.begin(); it < first.end(); ++it) {
+            for (Cover::const_iterator other = second.begin(); other < second.end(); ++other) {
+                if ((it->first ^ other->first) & ~it->second & ~other->second) {
+                    continue;
+                }
+
+                unsigned int dash_mask = it->second & other->second;
+                product.push_back(Cube((it->first | other->first) & ~dash_mask, dash_mask));
+            }
+        }
+
+        absorb(product);
+        return product;
+    }
+
+    /**
+     * Recursive descent over sum := product ('+' product)*,
+     * product := factor+ and factor := (letter | 0 | 1 | '(' sum ')') '*,
+     * every rule returning its cover.
+     */
+    class ExpressionParser {
+        public:
+            ExpressionParser(const std::string& text, size_t literals_count) :
+                _text(text),
+                _position(0),
+                _literals_count(literals_count),
+                _all((literals_count == 32) ? ~0u : ((1u << literals_count) - 1))
+            {
+            }
+
+            Cover parse() {
+                Cover cover = parseSum();
+                if (peek() != 0) {
+                    throw std::runtime_error(error(std::string("unexpected '") + peek() + "'"));
+                }
+
+                return cover;
+            }
+
+        private:
+            Cover parseSum() {
+                Cover sum = parseProduct();
+                while (peek() == '+') {
+                    _position++;
+                    Cover product = parseProduct();
+                    sum.insert(sum.end(), product.begin(), product.end());
+                }
+
+                absorb(sum);
+                return sum;
+            }
+
+            Cover parseProduct() {
+                Cover product = parseFactor();
+                for (char c = peek(); c == '(' || c == '0' || c == '1' || (c >= 'a' && c <= 'z'); c = peek()) {
+                    product = conjoin(product, parseFactor());
+                }
+
+                return product;
+            }
+
+            Cover parseFactor() {
+                Cover factor;
+                char c = peek();
+                if (c == '(') {
+                    _position++;
+                    factor = parseSum();
+                    if (peek() != ')') {
+                        throw std::runtime_error(error("missing ')'"));
+                    }
+
+                    _position++;
+                } else if (c == '0') {
+                    _position++;
+                } else if (c == '1') {
+                    _position++;
+                    factor.push_back(Cube(0, _all));
+                } else if (c >= 'a' && c <= 'z') {
+                    if ((size_t)(c - 'a') >= _literals_count) {
+                        throw std::runtime_error(error(std::string("literal '") + c + "' past the literals count"));
+                    }
+
+                    _position++;
+                    unsigned int bit = 1u << (_literals_count - 1 - (c - 'a'));
+                    factor.push_back(Cube(bit, _all & ~bit));
+                } else if (c == 0) {
+                    throw std::runtime_error(error("unexpected end"));
+                } else {
+                    throw std::runtime_error(error(std::string("unexpected '") + c + "'"));
+                }
+
+                while (peek() == '\'') {
+                    _position++;
+                    factor = complement(factor);
+                }
+
+                return factor;
+            }
+
+            // De Morgan: the product, over the cubes, of their negated literals
+            Cover complement(const Cover& cover) {
+                Cover result(1, Cube(0, _all));
+                for (Cover::const_iterator it = cover.begin(); it < cover.end(); ++it) {
+                    Cover negated;
+                    for (unsigned int bits = _all & ~it->second; bits != 0; bits &= bits - 1) {
+                        unsigned int bit = bits & -bits;
+                        negated.push_back(Cube(~it->first & bit, _all & ~bit));
+                    }
+
+                    result = conjoin(result, negated);
+                }
+
+                return result;
+            }
+
+            // the next character past the spaces, 0 at the end
+            char peek() {
+                while (_position < _text.length() && isspace((unsigned char)_text.at(_position))) {
+                    _position++;
+                }
+
+                return _position < _text.length() ? _text.at(_position) : 0;
+            }
+
+            std::string error(const std::string& message) const {
+                std::stringstream error;
+                error << "expression column " << _position + 1 << ": " << message;
+                return error.str();
+            }
+
+            std::string _text;
+            size_t _position;
+            size_t _literals_count;
+            unsigned int _all;
+    };
+}
+
+bool parse_cube(const std::string& text, Cube& cube) {
+    if (text.empty() || text.length() > 32) {
+        return false;
+    }
+
+    cube.first = 0;
+    cube.second = 0;
+    for (size_t i = 0; i < text.length(); ++i) {
+        unsigned int bit = 1u << (text.length() - i - 1);
+        switch (text.at(i)) {
+            case '0':
+                break;
+            case '1':
+                cube.first |= bit;
+                break;
+            case '-':
+                cube.second |= bit;
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void read_pla(std::istream& input,
+              size_t& literals_count,
+              std::vector<Cube>& onCubes,
+              std::vector<Cube>& dontCareCubes)
+{
+    literals_count = 0;
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::stringstream tokens(line);
+        std::string first;
+        if (!(tokens >> first)) {
+            continue;
+        }
+
+        if (first.at(0) == '.') {
+            if (first == ".i") {
+                if (!(tokens >> literals_count) || literals_count == 0 || literals_count > 32) {
+                    throw std::runtime_error(pla_error(line_number, "invalid .i"));
+                }
+            } else if (first == ".o") {
+                size_t outputs = 0;
+                if (!(tokens >> outputs) || outputs != 1) {
+                    throw std::runtime_error(pla_error(line_number, "only single output PLAs are supported"));
+                }
+            } else if (first == ".e" || first == ".end") {
+                break;
+            }
+
+            // .p, .ilb, .ob, .type and friends carry nothing we need
+            continue;
+        }
+
+        std::string output;
+        if (!(tokens >> output)) {
+            output = "1";
+        }
+
+        Cube cube;
+        if (!parse_cube(first, cube)) {
+            throw std::runtime_error(pla_error(line_number, "invalid cube '" + first + "'"));
+        }
+
+        if (literals_count == 0) {
+            literals_count = first.length();
+        }
+
+        if (first.length() != literals_count) {
+            throw std::runtime_error(pla_error(line_number, "cube width does not match .i"));
+        }
+
+        if (output == "1") {
+            onCubes.push_back(cube);
+        } else if (output == "-" || output == "2") {
+            dontCareCubes.push_back(cube);
+        } else if (output != "0" && output != "~") {
+            throw std::runtime_error(pla_error(line_number, "invalid output '" + output + "'"));
+        }
+    }
+}
+
+size_t expression_literals_count(const std::string& text) {
+    size_t literals_count = 0;
+    for (std::string::const_iterator it = text.begin(); it < text.end(); ++it) {
+        if (*it >= 'a' && *it <= 'z') {
+            literals_count = std::max(literals_count, (size_t)(*it - 'a') + 1);
+        }
+    }
+
+    return literals_count;
+}
+
+void parse_expression(const std::string& text, size_t literals_count, std::vector<Cube>& cubes) {
+    ExpressionParser parser(text, literals_count);
+    Cover cover = parser.parse();
+    cubes.insert(cubes.end(), cover.begin(), cover.end());
+}
+
+void expand_cubes(const std::vector<Cube>& cubes, std::vector<unsigned int>& values) {
+    for (std::vector<Cube>::const_iterator it = cubes.begin(); it < cubes.end(); ++it) {
+        unsigned int subset = 0;
+        do {
+            values.push_back(it->first | subset);
+            subset = (subset - it->second) & it->second;
+        } while (subset != 0);
+    }
+}
@@ -0,0 +1,39 @@
+#include "../include/deadline.h"
+
+#include <ctime>
+
+Deadline::Deadline(double budget_ms) :
+    _start(now()),
+    _budget_ms(budget_ms)
+{
+}
+
+Deadline::~Deadline() {
+}
+
+bool Deadline::isSet() const {
+    return _budget_ms > 0;
+}
+
+bool Deadline::expired() const {
+    return isSet() && elapsed() >= _budget_ms;
+}
+
+double Deadline::elapsed() const {
+    return now() - _start;
+}
+
+double Deadline::remaining() const {
+    if (!isSet()) {
+        return 0;
+    }
+
+    double remaining = _budget_ms - elapsed();
+    return remaining > 0 ? remaining : 0;
+}
+
+double Deadline::now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
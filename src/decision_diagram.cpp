@@ -0,0 +1,603 @@
+#include "../include/decision_diagram.h"
+#include "../include/memory_budget.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // ADD nodes and best gains kept across zddBestCube() calls
+    const size_t ADD_CACHE_LIMIT = (size_t)1 << 20;
+
+    // charged per node: the node, its unique table entry and its share of
+    // the operation caches (about what a run measures)
+    const size_t DIAGRAM_NODE_BYTES = 256;
+}
+
+DecisionDiagram::DecisionDiagram(size_t variables_count) :
+    _variables_count(variables_count),
+    _bdd(),
+    _zdd(),
+    _bdd_unique(),
+    _zdd_unique(),
+    _and_cache(),
+    _union_cache(),
+    _difference_cache(),
+    _primes_cache(),
+    _add(),
+    _add_values(),
+    _add_unique(),
+    _add_terminals(),
+    _add_cache(),
+    _plus_cache(),
+    _total_cache(),
+    _gain_cache(),
+    _charged_bytes(0)
+{
+    // terminals sit below every variable
+    _bdd.push_back(DiagramNode(variables_count, ZERO, ZERO));
+    _bdd.push_back(DiagramNode(variables_count, ONE, ONE));
+    _zdd.push_back(DiagramNode(2 * variables_count, ZERO, ZERO));
+    _zdd.push_back(DiagramNode(2 * variables_count, ONE, ONE));
+}
+
+DecisionDiagram::~DecisionDiagram() {
+    MemoryBudget::instance().release(_charged_bytes);
+}
+
+void DecisionDiagram::charge() {
+    MemoryBudget::instance().allocate(DIAGRAM_NODE_BYTES);
+    _charged_bytes += DIAGRAM_NODE_BYTES;
+}
+
+uint64_t DecisionDiagram::key(Node left, Node right) {
+    return ((uint64_t)left << 32) | right;
+}
+
+DecisionDiagram::Node DecisionDiagram::bddNode(size_t variable, Node low, Node high) {
+    if (low == high) {
+        return low;
+    }
+
+    std::pair<unsigned int, uint64_t> node_key(variable, key(low, high));
+    UniqueTable::iterator position = _bdd_unique.find(node_key);
+    if (position != _bdd_unique.end()) {
+        return position->second;
+    }
+
+    charge();
+    Node node = _bdd.size();
+    _bdd.push_back(DiagramNode(variable, low, high));
+    _bdd_unique[node_key] = node;
+    return node;
+}
+
+DecisionDiagram::Node DecisionDiagram::zddNode(size_t variable, Node low, Node high) {
+    if (high == ZERO) {
+        return low;
+    }
+
+    std::pair<unsigned int, uint64_t> node_key(variable, key(low, high));
+    UniqueTable::iterator position = _zdd_unique.find(node_key);
+    if (position != _zdd_unique.end()) {
+        return position->second;
+    }
+
+    charge();
+    Node node = _zdd.size();
+    _zdd.push_back(DiagramNode(variable, low, high));
+    _zdd_unique[node_key] = node;
+    return node;
+}
+
+DecisionDiagram::Node DecisionDiagram::bddFromMinterms(const std::vector<unsigned int>& minterms) {
+    std::vector<unsigned int> sorted(minterms);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    return bddFromMinterms(sorted, 0, sorted.size(), 0);
+}
+
+DecisionDiagram::Node DecisionDiagram::bddFromMinterms(const std::vector<unsigned int>& minterms,
+                                                       size_t begin, size_t end, size_t variable)
+{
+    if (begin == end) {
+        return ZERO;
+    }
+
+    if (variable == _variables_count) {
+        return ONE;
+    }
+
+    // minterms are sorted, so the ones with the variable's bit cleared
+    // come first within the current (equal prefix) range.
+    unsigned int bit = 1u << (_variables_count - variable - 1);
+    size_t middle = begin;
+    while (middle < end && !(minterms[middle] & bit)) {
+        middle++;
+    }
+
+    Node low = bddFromMinterms(minterms, begin, middle, variable + 1);
+    Node high = bddFromMinterms(minterms, middle, end, variable + 1);
+    return bddNode(variable, low, high);
+}
+
+DecisionDiagram::Node DecisionDiagram::bddAnd(Node left, Node right) {
+    if (left == ZERO || right == ZERO) {
+        return ZERO;
+    }
+
+    if (left == ONE || left == right) {
+        return right;
+    }
+
+    if (right == ONE) {
+        return left;
+    }
+
+    if (left > right) {
+        std::swap(left, right);
+    }
+
+    OperationCache::iterator position = _and_cache.find(key(left, right));
+    if (position != _and_cache.end()) {
+        return position->second;
+    }
+
+    unsigned int variable = std::min(_bdd[left].variable, _bdd[right].variable);
+    Node left_low = _bdd[left].variable == variable ? _bdd[left].low : left;
+    Node left_high = _bdd[left].variable == variable ? _bdd[left].high : left;
+    Node right_low = _bdd[right].variable == variable ? _bdd[right].low : right;
+    Node right_high = _bdd[right].variable == variable ? _bdd[right].high : right;
+
+    Node low = bddAnd(left_low, right_low);
+    Node high = bddAnd(left_high, right_high);
+    Node result = bddNode(variable, low, high);
+
+    _and_cache[key(left, right)] = result;
+    return result;
+}
+
+DecisionDiagram::Node DecisionDiagram::bddWithoutCube(Node function, unsigned int value, unsigned int dash_mask) {
+    OperationCache cache;
+    return bddWithoutCube(function, 0, value, dash_mask, cache);
+}
+
+DecisionDiagram::Node DecisionDiagram::bddWithoutCube(Node function, size_t variable, unsigned int value,
+                                                      unsigned int dash_mask, OperationCache& cache)
+{
+    // past the last variable, the minterm is inside the cube
+    if (function == ZERO || variable == _variables_count) {
+        return ZERO;
+    }
+
+    OperationCache::iterator position = cache.find(key(function, variable));
+    if (position != cache.end()) {
+        return position->second;
+    }
+
+    Node low = _bdd[function].variable == variable ? _bdd[function].low : function;
+    Node high = _bdd[function].variable == variable ? _bdd[function].high : function;
+    unsigned int bit = 1u << (_variables_count - variable - 1);
+    if ((dash_mask & bit) || !(value & bit)) {
+        low = bddWithoutCube(low, variable + 1, value, dash_mask, cache);
+    }
+
+    if ((dash_mask & bit) || (value & bit)) {
+        high = bddWithoutCube(high, variable + 1, value, dash_mask, cache);
+    }
+
+    Node result = bddNode(variable, low, high);
+    cache[key(function, variable)] = result;
+    return result;
+}
+
+bool DecisionDiagram::bddContains(Node function, unsigned int minterm) {
+    while (function != ZERO && function != ONE) {
+        unsigned int bit = (minterm >> (_variables_count - _bdd[function].variable - 1)) & 1;
+        function = bit ? _bdd[function].high : _bdd[function].low;
+    }
+
+    return function == ONE;
+}
+
+DecisionDiagram::Node DecisionDiagram::zddUnion(Node left, Node right) {
+    if (left == ZERO || left == right) {
+        return right;
+    }
+
+    if (right == ZERO) {
+        return left;
+    }
+
+    if (left > right) {
+        std::swap(left, right);
+    }
+
+    OperationCache::iterator position = _union_cache.find(key(left, right));
+    if (position != _union_cache.end()) {
+        return position->second;
+    }
+
+    Node result;
+    if (_zdd[left].variable < _zdd[right].variable) {
+        result = zddNode(_zdd[left].variable, zddUnion(_zdd[left].low, right), _zdd[left].high);
+    } else if (_zdd[left].variable > _zdd[right].variable) {
+        result = zddNode(_zdd[right].variable, zddUnion(left, _zdd[right].low), _zdd[right].high);
+    } else {
+        result = zddNode(_zdd[left].variable,
+                         zddUnion(_zdd[left].low, _zdd[right].low),
+                         zddUnion(_zdd[left].high, _zdd[right].high));
+    }
+
+    _union_cache[key(left, right)] = result;
+    return result;
+}
+
+DecisionDiagram::Node DecisionDiagram::zddDifference(Node left, Node right) {
+    if (left == ZERO || left == right) {
+        return ZERO;
+    }
+
+    if (right == ZERO) {
+        return left;
+    }
+
+    OperationCache::iterator position = _difference_cache.find(key(left, right));
+    if (position != _difference_cache.end()) {
+        return position->second;
+    }
+
+    Node result;
+    if (_zdd[left].variable < _zdd[right].variable) {
+        result = zddNode(_zdd[left].variable,
+                         zddDifference(_zdd[left].low, right),
+                         _zdd[left].high);
+    } else if (_zdd[left].variable > _zdd[right].variable) {
+        result = zddDifference(left, _zdd[right].low);
+    } else {
+        result = zddNode(_zdd[left].variable,
+                         zddDifference(_zdd[left].low, _zdd[right].low),
+                         zddDifference(_zdd[left].high, _zdd[right].high));
+    }
+
+    _difference_cache[key(left, right)] = result;
+    return result;
+}
+
+DecisionDiagram::Node DecisionDiagram::primes(Node function) {
+    if (function == ZERO) {
+        return ZERO;
+    }
+
+    if (function == ONE) {
+        return ONE;
+    }
+
+    std::tr1::unordered_map<Node, Node>::iterator position = _primes_cache.find(function);
+    if (position != _primes_cache.end()) {
+        return position->second;
+    }
+
+    // Coudert-Madre: with f = x'f0 + xf1, the primes of f are the primes of
+    // f0.f1 (which do not depend on x), plus x' (resp. x) times the primes
+    // of f0 (resp. f1) that are not already primes of f0.f1.
+    unsigned int variable = _bdd[function].variable;
+    Node low = _bdd[function].low;
+    Node high = _bdd[function].high;
+
+    Node both = primes(bddAnd(low, high));
+    Node negative = zddDifference(primes(low), both);
+    Node positive = zddDifference(primes(high), both);
+
+    Node result = zddNode(2 * variable,
+                          zddNode(2 * variable + 1, both, negative),
+                          positive);
+
+    _primes_cache[function] = result;
+    return result;
+}
+
+/**
+ * The gain of a cube is the number of minterms of function it holds. As an
+ * ADD counting minterms, function is walked down with the cube: a literal
+ * takes its cofactor, a dash the sum of both cofactors, so a path of the
+ * ZDD ends with its cube's gain and the best one is a max over the paths,
+ * memoized per (ZDD node, ADD node) pair.
+ */
+double DecisionDiagram::zddBestCube(Node cubes, Node function, std::pair<unsigned int, unsigned int>& cube) {
+    // the ADDs are kept for the next search, up to a point
+    if (_add.size() + _gain_cache.size() > ADD_CACHE_LIMIT) {
+        MemoryBudget::instance().release(_add.size() * DIAGRAM_NODE_BYTES);
+        _charged_bytes -= _add.size() * DIAGRAM_NODE_BYTES;
+        _add.clear();
+        _add_values.clear();
+        _add_unique.clear();
+        _add_terminals.clear();
+        _add_cache.clear();
+        _plus_cache.clear();
+        _total_cache.clear();
+        _gain_cache.clear();
+    }
+
+    Node add = addFromBdd(function);
+    double gain = zddGain(cubes, add, 0);
+    if (gain < 0) {
+        return gain;
+    }
+
+    // down the path of the best gain
+    unsigned int value = 0;
+    unsigned int care = 0;
+    while (cubes != ONE) {
+        unsigned int variable = gainTop(cubes, add);
+        Node rest = cubes;
+        Node positive = ZERO;
+        Node negative = ZERO;
+        if (_zdd[rest].variable == 2 * variable) {
+            positive = _zdd[rest].high;
+            rest = _zdd[rest].low;
+        }
+
+        if (_zdd[rest].variable == 2 * variable + 1) {
+            negative = _zdd[rest].high;
+            rest = _zdd[rest].low;
+        }
+
+        Node low = _add[add].variable == variable ? _add[add].low : add;
+        Node high = _add[add].variable == variable ? _add[add].high : add;
+        Node both = rest != ZERO ? addPlus(low, high) : low;
+        double dash_gain = zddGain(rest, both, variable + 1);
+        double positive_gain = zddGain(positive, high, variable + 1);
+        double negative_gain = zddGain(negative, low, variable + 1);
+
+        unsigned int bit = 1u << (_variables_count - variable - 1);
+        if (dash_gain >= positive_gain && dash_gain >= negative_gain) {
+            cubes = rest;
+            add = both;
+        } else if (positive_gain >= negative_gain) {
+            cubes = positive;
+            add = high;
+            value |= bit;
+            care |= bit;
+        } else {
+            cubes = negative;
+            add = low;
+            care |= bit;
+        }
+    }
+
+    unsigned int all = (_variables_count == 32) ? ~0u : ((1u << _variables_count) - 1);
+    cube = std::make_pair(value, all & ~care);
+    return gain;
+}
+
+DecisionDiagram::Node DecisionDiagram::addTerminal(double value) {
+    std::tr1::unordered_map<double, Node>::iterator position = _add_terminals.find(value);
+    if (position != _add_terminals.end()) {
+        return position->second;
+    }
+
+    charge();
+    Node node = _add.size();
+    _add.push_back(DiagramNode(_variables_count, node, node));
+    _add_values.push_back(value);
+    _add_terminals[value] = node;
+    return node;
+}
+
+DecisionDiagram::Node DecisionDiagram::addNode(size_t variable, Node low, Node high) {
+    if (low == high) {
+        return low;
+    }
+
+    std::pair<unsigned int, uint64_t> node_key(variable, key(low, high));
+    UniqueTable::iterator position = _add_unique.find(node_key);
+    if (position != _add_unique.end()) {
+        return position->second;
+    }
+
+    charge();
+    Node node = _add.size();
+    _add.push_back(DiagramNode(variable, low, high));
+    _add_values.push_back(0);
+    _add_unique[node_key] = node;
+    return node;
+}
+
+DecisionDiagram::Node DecisionDiagram::addFromBdd(Node function) {
+    if (function == ZERO || function == ONE) {
+        return addTerminal(function);
+    }
+
+    std::tr1::unordered_map<Node, Node>::iterator position = _add_cache.find(function);
+    if (position != _add_cache.end()) {
+        return position->second;
+    }
+
+    Node result = addNode(_bdd[function].variable,
+                          addFromBdd(_bdd[function].low),
+                          addFromBdd(_bdd[function].high));
+    _add_cache[function] = result;
+    return result;
+}
+
+DecisionDiagram::Node DecisionDiagram::addPlus(Node left, Node right) {
+    if (left > right) {
+        std::swap(left, right);
+    }
+
+    unsigned int variable = std::min(_add[left].variable, _add[right].variable);
+    if (variable == _variables_count) {
+        return addTerminal(_add_values[left] + _add_values[right]);
+    }
+
+    OperationCache::iterator position = _plus_cache.find(key(left, right));
+    if (position != _plus_cache.end()) {
+        return position->second;
+    }
+
+    Node left_low = _add[left].variable == variable ? _add[left].low : left;
+    Node left_high = _add[left].variable == variable ? _add[left].high : left;
+    Node right_low = _add[right].variable == variable ? _add[right].low : right;
+    Node right_high = _add[right].variable == variable ? _add[right].high : right;
+
+    Node result = addNode(variable, addPlus(left_low, right_low), addPlus(left_high, right_high));
+    _plus_cache[key(left, right)] = result;
+    return result;
+}
+
+// the sum of add over the assignments of the variables from variable on
+double DecisionDiagram::addTotal(Node add, size_t variable) {
+    unsigned int top = _add[add].variable;
+    double total = 0;
+    if (top == _variables_count) {
+        total = _add_values[add];
+    } else {
+        std::tr1::unordered_map<Node, double>::iterator position = _total_cache.find(add);
+        if (position != _total_cache.end()) {
+            total = position->second;
+        } else {
+            total = addTotal(_add[add].low, top + 1) + addTotal(_add[add].high, top + 1);
+            _total_cache[add] = total;
+        }
+    }
+
+    return std::ldexp(total, (int)top - (int)variable);
+}
+
+unsigned int DecisionDiagram::gainTop(Node cubes, Node add) const {
+    return std::min(_zdd[cubes].variable / 2, _add[add].variable);
+}
+
+/**
+ * The best gain of the cubes over the variables from variable on, add
+ * holding the minterm counts. Above the top variable of both, a cube can
+ * only have dashes, and each one doubles the gain.
+ */
+double DecisionDiagram::zddGain(Node cubes, Node add, size_t variable) {
+    if (cubes == ZERO) {
+        return -1;
+    }
+
+    unsigned int top = gainTop(cubes, add);
+    if (cubes == ONE) {
+        return addTotal(add, variable);
+    }
+
+    if (_add[add].variable == _variables_count && _add_values[add] == 0) {
+        return 0;
+    }
+
+    double gain = 0;
+    std::tr1::unordered_map<uint64_t, double>::iterator position = _gain_cache.find(key(cubes, add));
+    if (position != _gain_cache.end()) {
+        gain = position->second;
+    } else {
+        Node rest = cubes;
+        Node positive = ZERO;
+        Node negative = ZERO;
+        if (_zdd[rest].variable == 2 * top) {
+            positive = _zdd[rest].high;
+            rest = _zdd[rest].low;
+        }
+
+        if (_zdd[rest].variable == 2 * top + 1) {
+            negative = _zdd[rest].high;
+            rest = _zdd[rest].low;
+        }
+
+        Node low = _add[add].variable == top ? _add[add].low : add;
+        Node high = _add[add].variable == top ? _add[add].high : add;
+        gain = rest != ZERO ? zddGain(rest, addPlus(low, high), top + 1) : -1;
+        gain = std::max(gain, zddGain(positive, high, top + 1));
+        gain = std::max(gain, zddGain(negative, low, top + 1));
+        _gain_cache[key(cubes, add)] = gain;
+    }
+
+    return std::ldexp(gain, (int)top - (int)variable);
+}
+
+DecisionDiagram::Node DecisionDiagram::zddContaining(Node cubes, unsigned int minterm) {
+    OperationCache cache;
+    return zddContaining(cubes, minterm, cache);
+}
+
+DecisionDiagram::Node DecisionDiagram::zddContaining(Node cubes, unsigned int minterm, OperationCache& cache) {
+    if (cubes == ZERO || cubes == ONE) {
+        return cubes;
+    }
+
+    OperationCache::iterator position = cache.find(cubes);
+    if (position != cache.end()) {
+        return position->second;
+    }
+
+    unsigned int variable = _zdd[cubes].variable;
+    unsigned int bit = (minterm >> (_variables_count - variable / 2 - 1)) & 1;
+    bool positive = (variable % 2 == 0);
+
+    Node low = zddContaining(_zdd[cubes].low, minterm, cache);
+    Node result = low;
+    if (positive == (bit == 1)) {
+        // the literal agrees with the minterm, cubes holding it stay
+        result = zddNode(variable, low, zddContaining(_zdd[cubes].high, minterm, cache));
+    }
+
+    cache[cubes] = result;
+    return result;
+}
+
+double DecisionDiagram::zddCount(Node cubes) {
+    std::tr1::unordered_map<Node, double> cache;
+    return zddCount(cubes, cache);
+}
+
+double DecisionDiagram::zddCount(Node cubes, std::tr1::unordered_map<Node, double>& cache) {
+    if (cubes == ZERO || cubes == ONE) {
+        return cubes;
+    }
+
+    std::tr1::unordered_map<Node, double>::iterator position = cache.find(cubes);
+    if (position != cache.end()) {
+        return position->second;
+    }
+
+    double count = zddCount(_zdd[cubes].low, cache) + zddCount(_zdd[cubes].high, cache);
+    cache[cubes] = count;
+    return count;
+}
+
+void DecisionDiagram::zddCubes(Node cubes, std::vector<std::pair<unsigned int, unsigned int> >& output) {
+    zddCubes(cubes, 0, 0, output);
+}
+
+void DecisionDiagram::zddCubes(Node cubes, unsigned int value, unsigned int care,
+                               std::vector<std::pair<unsigned int, unsigned int> >& output)
+{
+    if (cubes == ZERO) {
+        return;
+    }
+
+    if (cubes == ONE) {
+        unsigned int all = (_variables_count == 32) ? ~0u : ((1u << _variables_count) - 1);
+        output.push_back(std::make_pair(value, all & ~care));
+        return;
+    }
+
+    unsigned int variable = _zdd[cubes].variable;
+    unsigned int bit = 1u << (_variables_count - variable / 2 - 1);
+
+    zddCubes(_zdd[cubes].low, value, care, output);
+    zddCubes(_zdd[cubes].high,
+             (variable % 2 == 0) ? (value | bit) : value,
+             care | bit,
+             output);
+}
+
+size_t DecisionDiagram::getBddNodesCount() const {
+    return _bdd.size();
+}
+
+size_t DecisionDiagram::getZddNodesCount() const {
+    return _zdd.size();
+}
@@ -0,0 +1,216 @@
+#include "../include/engine_selector.h"
+#include "../include/cover_table.h"
+#include "../include/minterm_input.h"
+#include "../include/shannon_engine.h"
+#include "../include/ternary_engine.h"
+
+#include <algorithm>
+#include <random>
+
+namespace {
+    // variables per sampled subcube, and how many subcubes
+    const size_t SAMPLE_LITERALS = 8;
+    const size_t SAMPLES_COUNT = 32;
+
+    double binomial(size_t n, size_t k) {
+        double result = 1;
+        for (size_t i = 1; i <= k; ++i) {
+            result = result * (n - k + i) / i;
+        }
+
+        return result;
+    }
+
+    // estimates print as whole numbers
+    unsigned long long rounded(double value) {
+        return (unsigned long long)(value + 0.5);
+    }
+}
+
+FunctionStats::FunctionStats(const std::vector<unsigned int>& onValues,
+                             const std::vector<unsigned int>& dontCareValues,
+                             size_t cubes_count, size_t literals_count) :
+    _literals_count(literals_count),
+    _cubes_count(cubes_count),
+    _on_density(0),
+    _dont_care_density(0),
+    _level_implicants(),
+    _implicants(0)
+{
+    double minterms_count = (double)((uint64_t)1 << literals_count);
+    _on_density = onValues.size() / minterms_count;
+    _dont_care_density = dontCareValues.size() / minterms_count;
+
+    std::vector<unsigned int> care(onValues);
+    care.insert(care.end(), dontCareValues.begin(), dontCareValues.end());
+    std::sort(care.begin(), care.end());
+    care.erase(std::unique(care.begin(), care.end()), care.end());
+
+    _level_implicants.push_back(care.size());
+    if (cubes_count == 0 && !care.empty() && literals_count > 0) {
+        sample(care);
+    }
+
+    for (std::vector<double>::iterator it = _level_implicants.begin();
+         it < _level_implicants.end(); ++it)
+    {
+        _implicants += *it;
+    }
+}
+
+FunctionStats::~FunctionStats() {
+}
+
+size_t FunctionStats::getLiteralsCount() const {
+    return _literals_count;
+}
+
+size_t FunctionStats::getCubesCount() const {
+    return _cubes_count;
+}
+
+double FunctionStats::getOnDensity() const {
+    return _on_density;
+}
+
+double FunctionStats::getDontCareDensity() const {
+    return _dont_care_density;
+}
+
+const std::vector<double>& FunctionStats::getLevelImplicants() const {
+    return _level_implicants;
+}
+
+double FunctionStats::getImplicants() const {
+    return _implicants;
+}
+
+void FunctionStats::print(std::ostream& output) const {
+    output << _literals_count << " literals";
+    if (_cubes_count > 0) {
+        output << ", " << _cubes_count << " cubes";
+        return;
+    }
+
+    output << ", ON " << _on_density * 100 << "%, Dont-Care " << _dont_care_density * 100
+           << "%, ~" << rounded(_implicants) << " implicants (per level:";
+    for (std::vector<double>::const_iterator it = _level_implicants.begin();
+         it < _level_implicants.end(); ++it)
+    {
+        output << " " << rounded(*it);
+    }
+
+    output << ")";
+}
+
+/**
+ * A cube with j dashes around a care minterm m is an implicant with some
+ * probability q_j; counted over the care minterms, each implicant is met
+ * once per minterm, so level j holds about |care| * q_j * C(n, j) / 2^j
+ * implicants. q_j is measured on subcubes around evenly spread care
+ * minterms, and extrapolated past SAMPLE_LITERALS dashes.
+ */
+void FunctionStats::sample(const std::vector<unsigned int>& care) {
+    size_t sample_literals = std::min(_literals_count, SAMPLE_LITERALS);
+    size_t values_count = (size_t)1 << sample_literals;
+
+    // the same function always gets the same estimate
+    std::minstd_rand random(_literals_count);
+    std::vector<size_t> hits(sample_literals + 1);
+    std::vector< std::vector<char> > implicants(values_count, std::vector<char>(values_count));
+    std::vector<unsigned int> variables(_literals_count);
+    for (size_t samples = 0; samples < SAMPLES_COUNT; ++samples) {
+        unsigned int anchor = care[samples * care.size() / SAMPLES_COUNT];
+        for (size_t i = 0; i < _literals_count; ++i) {
+            variables[i] = i;
+        }
+
+        for (size_t i = 0; i < sample_literals; ++i) {
+            std::swap(variables[i], variables[i + random() % (_literals_count - i)]);
+        }
+
+        // the anchor's value over the subcube's variables
+        unsigned int local = 0;
+        for (size_t i = 0; i < sample_literals; ++i) {
+            local |= (anchor & (1u << variables[i])) ? (1u << i) : 0;
+        }
+
+        // the subcube's minterms, then each mask from the one with a dash less
+        for (size_t value = 0; value < values_count; ++value) {
+            unsigned int minterm = anchor;
+            for (size_t i = 0; i < sample_literals; ++i) {
+                unsigned int bit = 1u << variables[i];
+                minterm = (value & (1u << i)) ? (minterm | bit) : (minterm & ~bit);
+            }
+
+            implicants[0][value] = std::binary_search(care.begin(), care.end(), minterm);
+        }
+
+        for (size_t mask = 1; mask < values_count; ++mask) {
+            size_t low = mask & (0 - mask);
+            for (size_t value = 0; value < values_count; ++value) {
+                if (!(value & mask)) {
+                    implicants[mask][value] = implicants[mask ^ low][value] &&
+                                              implicants[mask ^ low][value | low];
+                }
+            }
+
+            if (implicants[mask][local & ~mask]) {
+                hits[__builtin_popcount(mask)]++;
+            }
+        }
+    }
+
+    double ratio = 0;
+    double probability = 1;
+    for (size_t level = 1; level <= _literals_count; ++level) {
+        if (level <= sample_literals) {
+            double previous = probability;
+            probability = hits[level] / (SAMPLES_COUNT * binomial(sample_literals, level));
+            ratio = previous > 0 ? probability / previous : 0;
+        } else {
+            probability *= ratio;
+        }
+
+        double estimate = care.size() * probability * binomial(_literals_count, level) / ((uint64_t)1 << level);
+        if (estimate < 0.5) {
+            break;
+        }
+
+        _level_implicants.push_back(estimate);
+    }
+}
+
+std::string select_engine(const FunctionStats& stats, size_t implicants_limit, bool heuristic_fallback,
+                          bool& exact_cover)
+{
+    size_t literals_count = stats.getLiteralsCount();
+    exact_cover = false;
+
+    if (stats.getCubesCount() > 0) {
+        return "consensus";
+    }
+
+    if (literals_count <= COVER_TABLE_MAX_LITERALS) {
+        return "tabular";
+    }
+
+    if (implicants_limit > 0 && stats.getImplicants() > implicants_limit) {
+        return heuristic_fallback && literals_count <= MintermReader::BITMAP_MAX_LITERALS ? "heuristic" : "zdd";
+    }
+
+    if (stats.getImplicants() > AUTO_EXACT_IMPLICANTS) {
+        return "zdd";
+    }
+
+    exact_cover = true;
+    if (literals_count <= TERNARY_MAX_LITERALS) {
+        return "ternary";
+    }
+
+    if (literals_count <= SHANNON_MAX_LITERALS) {
+        return "shannon";
+    }
+
+    return "consensus";
+}
@@ -0,0 +1,406 @@
+#include "../include/external_combine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdint.h>
+
+namespace {
+    // spill files of concurrent minimizations (--best-form) never collide
+    std::atomic<unsigned int> files_count(0);
+
+    struct Record {
+        Record(uint32_t value = 0, bool dont_care = false) :
+            value(value),
+            dont_care(dont_care)
+        {
+        }
+
+        uint32_t value;
+        bool dont_care;
+    };
+
+    typedef std::vector<Record> Records;
+
+    // a mask's groups (number of ones) one after the other
+    struct RecordCompare {
+        bool operator()(const Record& first, const Record& second) const {
+            int first_ones = __builtin_popcount(first.value);
+            int second_ones = __builtin_popcount(second.value);
+            return first_ones != second_ones ? first_ones < second_ones : first.value < second.value;
+        }
+    };
+
+    // 5 bytes a record: the value, then the Dont-Care flag
+    void write_record(std::ostream& output, const Record& record) {
+        char bytes[5];
+        memcpy(bytes, &record.value, 4);
+        bytes[4] = record.dont_care;
+        output.write(bytes, sizeof(bytes));
+    }
+
+    bool read_record(std::istream& input, Record& record) {
+        char bytes[5];
+        if (!input.read(bytes, sizeof(bytes))) {
+            return false;
+        }
+
+        memcpy(&record.value, bytes, 4);
+        record.dont_care = bytes[4] != 0;
+        return true;
+    }
+
+    class RunReader {
+        public:
+            RunReader(const std::string& path) :
+                _input(path.c_str(), std::ios::binary),
+                _record(),
+                _valid(false)
+            {
+                if (!_input) {
+                    throw std::runtime_error("cannot read '" + path + "'");
+                }
+
+                advance();
+            }
+
+            bool isValid() const {
+                return _valid;
+            }
+
+            const Record& get() const {
+                return _record;
+            }
+
+            void advance() {
+                _valid = read_record(_input, _record);
+            }
+
+        private:
+            std::ifstream _input;
+            Record _record;
+            bool _valid;
+    };
+
+    /**
+     * Streams the records of several sorted runs in order, merging them
+     * on the fly.
+     */
+    class RunMerger {
+        public:
+            RunMerger(const std::vector<std::string>& paths) :
+                _readers()
+            {
+                try {
+                    for (std::vector<std::string>::const_iterator it = paths.begin(); it < paths.end(); ++it) {
+                        _readers.push_back(new RunReader(*it));
+                    }
+                } catch (...) {
+                    clear();
+                    throw;
+                }
+            }
+
+            virtual ~RunMerger() {
+                clear();
+            }
+
+            bool next(Record& record) {
+                RunReader* smallest = 0;
+                RecordCompare compare;
+                for (std::vector<RunReader*>::iterator it = _readers.begin(); it < _readers.end(); ++it) {
+                    if ((*it)->isValid() && (smallest == 0 || compare((*it)->get(), smallest->get()))) {
+                        smallest = *it;
+                    }
+                }
+
+                if (smallest == 0) {
+                    return false;
+                }
+
+                record = smallest->get();
+                smallest->advance();
+                return true;
+            }
+
+        private:
+            RunMerger(const RunMerger&);
+            RunMerger& operator=(const RunMerger&);
+
+            void clear() {
+                for (std::vector<RunReader*>::iterator it = _readers.begin(); it < _readers.end(); ++it) {
+                    delete *it;
+                }
+
+                _readers.clear();
+            }
+
+            std::vector<RunReader*> _readers;
+    };
+
+    typedef std::map<unsigned int, std::vector<std::string> > Runs;
+
+    /**
+     * The levels on disk: the runs of the level being combined and those
+     * of the next one, which are buffered per dash mask and spilled when
+     * SPILL_BUFFER_RECORDS are held.
+     */
+    class Spill {
+        public:
+            Spill(const std::string& directory) :
+                _directory(directory),
+                _runs(),
+                _next_runs(),
+                _buffers(),
+                _buffered(0)
+            {
+                if (mkdir(_directory.c_str(), 0777) != 0 && errno != EEXIST) {
+                    throw std::runtime_error("cannot create spill directory '" + _directory + "': " +
+                                             strerror(errno));
+                }
+            }
+
+            virtual ~Spill() {
+                removeRuns(_runs);
+                removeRuns(_next_runs);
+            }
+
+            void add(unsigned int dash_mask, const Record& record) {
+                _buffers[dash_mask].push_back(record);
+                if (++_buffered >= SPILL_BUFFER_RECORDS) {
+                    flush();
+                }
+            }
+
+            // the next level becomes the current one; false once it is empty
+            bool nextLevel() {
+                flush();
+                removeRuns(_runs);
+                _runs.swap(_next_runs);
+                return !_runs.empty();
+            }
+
+            Runs& getRuns() {
+                return _runs;
+            }
+
+            // merges runs in passes until at most SPILL_MERGE_RUNS are left
+            void reduce(std::vector<std::string>& paths) {
+                while (paths.size() > SPILL_MERGE_RUNS) {
+                    std::vector<std::string> merged;
+                    for (size_t first = 0; first < paths.size(); first += SPILL_MERGE_RUNS) {
+                        size_t last = std::min(first + SPILL_MERGE_RUNS, paths.size());
+                        std::vector<std::string> pass(paths.begin() + first, paths.begin() + last);
+
+                        std::string path = newPath();
+                        std::ofstream output(path.c_str(), std::ios::binary);
+                        merged.push_back(path);
+
+                        RunMerger merger(pass);
+                        Record record;
+                        while (merger.next(record)) {
+                            write_record(output, record);
+                        }
+
+                        close(output, path);
+                        for (std::vector<std::string>::iterator it = pass.begin(); it < pass.end(); ++it) {
+                            std::remove(it->c_str());
+                        }
+                    }
+
+                    paths.swap(merged);
+                }
+            }
+
+        private:
+            void flush() {
+                for (std::map<unsigned int, Records>::iterator it = _buffers.begin(); it != _buffers.end(); ++it) {
+                    Records& records = it->second;
+                    std::sort(records.begin(), records.end(), RecordCompare());
+
+                    std::string path = newPath();
+                    std::ofstream output(path.c_str(), std::ios::binary);
+                    _next_runs[it->first].push_back(path);
+                    for (Records::iterator record = records.begin(); record < records.end(); ++record) {
+                        write_record(output, *record);
+                    }
+
+                    close(output, path);
+                }
+
+                _buffers.clear();
+                _buffered = 0;
+            }
+
+            std::string newPath() {
+                std::ostringstream path;
+                path << _directory << "/qmc-" << getpid() << "-" << files_count++ << ".run";
+                return path.str();
+            }
+
+            void close(std::ofstream& output, const std::string& path) {
+                output.close();
+                if (!output) {
+                    throw std::runtime_error("cannot write '" + path + "': " + strerror(errno));
+                }
+            }
+
+            void removeRuns(Runs& runs) {
+                for (Runs::iterator it = runs.begin(); it != runs.end(); ++it) {
+                    for (std::vector<std::string>::iterator path = it->second.begin();
+                         path < it->second.end(); ++path)
+                    {
+                        std::remove(path->c_str());
+                    }
+                }
+
+                runs.clear();
+            }
+
+            std::string _directory;
+            Runs _runs;
+            Runs _next_runs;
+            std::map<unsigned int, Records> _buffers;
+            size_t _buffered;
+    };
+
+    /**
+     * Reads a mask's groups one at a time from the merged runs, keeping
+     * the first record of the next group aside.
+     */
+    class GroupReader {
+        public:
+            GroupReader(RunMerger& merger) :
+                _merger(merger),
+                _pending(),
+                _has_pending(merger.next(_pending))
+            {
+            }
+
+            bool next(Records& group) {
+                group.clear();
+                if (!_has_pending) {
+                    return false;
+                }
+
+                int ones = __builtin_popcount(_pending.value);
+                do {
+                    group.push_back(_pending);
+                    _has_pending = _merger.next(_pending);
+                } while (_has_pending && __builtin_popcount(_pending.value) == ones);
+
+                return true;
+            }
+
+        private:
+            RunMerger& _merger;
+            Record _pending;
+            bool _has_pending;
+    };
+
+    struct ValueCompare {
+        bool operator()(const Record& record, uint32_t value) const {
+            return record.value < value;
+        }
+    };
+}
+
+void combine_external_terms(const std::vector<unsigned int>& onValues,
+                            const std::vector<unsigned int>& dontCareValues,
+                            size_t literals_count, const std::string& directory,
+                            Terms& terms, Terms& primeTerms)
+{
+    unsigned int all = (literals_count == 32) ? ~0u : ((1u << literals_count) - 1);
+    Spill spill(directory);
+
+    // level 0: the minterms, an ON one wins over a Dont-Care one
+    {
+        Records minterms;
+        for (std::vector<unsigned int>::const_iterator it = dontCareValues.begin();
+             it < dontCareValues.end(); ++it)
+        {
+            minterms.push_back(Record(*it, true));
+        }
+
+        for (std::vector<unsigned int>::const_iterator it = onValues.begin();
+             it < onValues.end(); ++it)
+        {
+            minterms.push_back(Record(*it, false));
+        }
+
+        std::stable_sort(minterms.begin(), minterms.end(), RecordCompare());
+        for (size_t i = 0; i < minterms.size(); ++i) {
+            if (i + 1 < minterms.size() && minterms[i + 1].value == minterms[i].value) {
+                continue;
+            }
+
+            spill.add(0, minterms[i]);
+        }
+    }
+
+    while (spill.nextLevel()) {
+        Runs& runs = spill.getRuns();
+        for (Runs::iterator it = runs.begin(); it != runs.end(); ++it) {
+            unsigned int dash_mask = it->first;
+            unsigned int lowest_dash = dash_mask & -dash_mask;
+            spill.reduce(it->second);
+
+            RunMerger merger(it->second);
+            GroupReader groups(merger);
+            Records lower;
+            Records upper;
+            std::vector<char> lowerSelected;
+            std::vector<char> upperSelected;
+            groups.next(lower);
+            lowerSelected.assign(lower.size(), false);
+            while (!lower.empty()) {
+                groups.next(upper);
+                upperSelected.assign(upper.size(), false);
+
+                if (!upper.empty() &&
+                    __builtin_popcount(upper.front().value) == __builtin_popcount(lower.front().value) + 1)
+                {
+                    for (size_t i = 0; i < lower.size(); ++i) {
+                        unsigned int value = lower[i].value;
+                        for (unsigned int bits = all & ~(dash_mask | value); bits != 0; bits &= bits - 1) {
+                            unsigned int bit = bits & -bits;
+                            Records::iterator position = std::lower_bound(upper.begin(), upper.end(),
+                                                                          value | bit, ValueCompare());
+                            if (position == upper.end() || position->value != (value | bit)) {
+                                continue;
+                            }
+
+                            lowerSelected[i] = true;
+                            upperSelected[position - upper.begin()] = true;
+
+                            // every cube is built along its lowest dash only
+                            if (lowest_dash == 0 || bit < lowest_dash) {
+                                spill.add(dash_mask | bit, Record(value, lower[i].dont_care &&
+                                                                         position->dont_care));
+                            }
+                        }
+                    }
+                }
+
+                for (size_t i = 0; i < lower.size(); ++i) {
+                    if (!lowerSelected[i] && !lower[i].dont_care) {
+                        Term* term = new Term(lower[i].value, dash_mask, literals_count);
+                        terms.push_back(term); // add to heap pointers vector
+                        primeTerms.push_back(term);
+                    }
+                }
+
+                lower.swap(upper);
+                lowerSelected.swap(upperSelected);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include "../include/heuristic.h"
+
+namespace {
+    bool is_implicant(const Bitmap& on_set, const Bitmap& dont_care_set,
+                      unsigned int value, unsigned int dash_mask)
+    {
+        unsigned int subset = 0;
+        do {
+            unsigned int minterm = value | subset;
+            if (!on_set.test(minterm) && !dont_care_set.test(minterm)) {
+                return false;
+            }
+
+            subset = (subset - dash_mask) & dash_mask;
+        } while (subset != 0);
+
+        return true;
+    }
+
+    bool contains(Term* term, unsigned int minterm) {
+        unsigned int dash_mask = term->getDashMask();
+        return (minterm & ~dash_mask) == (term->getDecimal() & ~dash_mask);
+    }
+
+    // drops cubes whose ON minterms are all covered by the other cubes
+    void make_irredundant(Terms& cover, const Bitmap& on_set) {
+        for (size_t i = cover.size(); i > 0; --i) {
+            Term* term = cover.at(i - 1);
+            bool redundant = true;
+
+            std::vector<size_t>& minterms = term->getMinterms();
+            for (std::vector<size_t>::iterator mt_it = minterms.begin();
+                 redundant && mt_it < minterms.end(); ++mt_it)
+            {
+                if (!on_set.test(*mt_it)) {
+                    continue;
+                }
+
+                bool covered = false;
+                for (Terms::iterator it = cover.begin(); it < cover.end(); ++it) {
+                    if (*it != term && contains(*it, *mt_it)) {
+                        covered = true;
+                        break;
+                    }
+                }
+
+                redundant = covered;
+            }
+
+            if (redundant) {
+                delete term;
+                cover.erase(cover.begin() + (i - 1));
+            }
+        }
+    }
+}
+
+Terms expand_cover(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count) {
+    Terms cover;
+    Bitmap covered(on_set.size());
+
+    for (size_t minterm = 0; minterm < on_set.size(); ++minterm) {
+        if (!on_set.test(minterm) || covered.test(minterm)) {
+            continue;
+        }
+
+        // raise literals from the most significant one ('a') down, as long
+        // as the mirrored half of the cube stays inside ON + Dont-Care.
+        unsigned int value = minterm;
+        unsigned int dash_mask = 0;
+        for (size_t i = literals_count; i > 0; --i) {
+            unsigned int bit = 1u << (i - 1);
+            if (is_implicant(on_set, dont_care_set, (value ^ bit) & ~dash_mask, dash_mask)) {
+                dash_mask |= bit;
+                value &= ~bit;
+            }
+        }
+
+        unsigned int subset = 0;
+        do {
+            covered.set(value | subset);
+            subset = (subset - dash_mask) & dash_mask;
+        } while (subset != 0);
+
+        cover.push_back(new Term(value, dash_mask, literals_count));
+    }
+
+    make_irredundant(cover, on_set);
+
+    return cover;
+}
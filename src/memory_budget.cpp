@@ -0,0 +1,123 @@
+#include "../include/memory_budget.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+MemoryBudgetExceeded::MemoryBudgetExceeded(const std::string& message) :
+    std::bad_alloc(),
+    _message(message)
+{
+}
+
+MemoryBudgetExceeded::~MemoryBudgetExceeded() throw() {
+}
+
+const char* MemoryBudgetExceeded::what() const throw() {
+    return _message.c_str();
+}
+
+MemoryBudget& MemoryBudget::instance() {
+    static MemoryBudget budget;
+    return budget;
+}
+
+MemoryBudget::MemoryBudget() :
+    _max_bytes(0),
+    _max_implicants(0),
+    _used_bytes(0),
+    _peak_bytes(0),
+    _implicants(0)
+{
+}
+
+void MemoryBudget::setMaxBytes(size_t max_bytes) {
+    _max_bytes = max_bytes;
+}
+
+void MemoryBudget::setMaxImplicants(size_t max_implicants) {
+    _max_implicants = max_implicants;
+}
+
+void MemoryBudget::disable() {
+    _max_bytes = 0;
+    _max_implicants = 0;
+}
+
+void MemoryBudget::allocate(size_t bytes) {
+    // charges may come from several combine threads at once
+    size_t used = _used_bytes.fetch_add(bytes) + bytes;
+    if (_max_bytes > 0 && used > _max_bytes) {
+        _used_bytes.fetch_sub(bytes);
+
+        std::stringstream message;
+        message << "memory budget of " << _max_bytes << " bytes exceeded ("
+                << used - bytes << " bytes in " << _implicants << " implicants)";
+        throw MemoryBudgetExceeded(message.str());
+    }
+
+    size_t peak = _peak_bytes.load();
+    while (used > peak && !_peak_bytes.compare_exchange_weak(peak, used)) {
+    }
+}
+
+void MemoryBudget::release(size_t bytes) {
+    _used_bytes.fetch_sub(bytes);
+}
+
+void MemoryBudget::addImplicant() {
+    size_t implicants = _implicants.fetch_add(1) + 1;
+    if (_max_implicants > 0 && implicants > _max_implicants) {
+        _implicants.fetch_sub(1);
+
+        std::stringstream message;
+        message << "implicant budget of " << _max_implicants << " exceeded";
+        throw MemoryBudgetExceeded(message.str());
+    }
+}
+
+void MemoryBudget::removeImplicant() {
+    _implicants.fetch_sub(1);
+}
+
+size_t MemoryBudget::getUsedBytes() const {
+    return _used_bytes;
+}
+
+size_t MemoryBudget::getPeakBytes() const {
+    return _peak_bytes;
+}
+
+size_t MemoryBudget::getImplicants() const {
+    return _implicants;
+}
+
+size_t MemoryBudget::getImplicantsLimit(size_t implicant_bytes) const {
+    size_t limit = _max_implicants;
+    if (_max_bytes > 0 && (limit == 0 || _max_bytes / implicant_bytes < limit)) {
+        limit = _max_bytes / implicant_bytes;
+    }
+
+    return limit;
+}
+
+size_t MemoryBudget::parseBytes(const std::string& value) {
+    char* end = 0;
+    double bytes = std::strtod(value.c_str(), &end);
+    if (end == value.c_str() || bytes < 0) {
+        throw std::invalid_argument("invalid memory size '" + value + "'");
+    }
+
+    std::string suffix(end);
+    if (suffix == "" || suffix == "B") {
+        return bytes;
+    } else if (suffix == "K" || suffix == "KB") {
+        return bytes * 1024;
+    } else if (suffix == "M" || suffix == "MB") {
+        return bytes * 1024 * 1024;
+    } else if (suffix == "G" || suffix == "GB") {
+        return bytes * 1024 * 1024 * 1024;
+    }
+
+    throw std::invalid_argument("invalid memory size suffix '" + suffix + "'");
+}
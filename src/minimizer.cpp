@@ -0,0 +1,403 @@
+#include "../include/minimizer.h"
+
+#include <algorithm>
+
+namespace {
+    uint64_t cube_key(unsigned int value, unsigned int dash_mask) {
+        return ((uint64_t)dash_mask << 32) | (value & ~dash_mask);
+    }
+
+    unsigned int key_value(uint64_t key) {
+        return key & 0xffffffffu;
+    }
+
+    unsigned int key_dash_mask(uint64_t key) {
+        return key >> 32;
+    }
+
+    bool holds(uint64_t key, unsigned int minterm) {
+        return (minterm & ~key_dash_mask(key)) == key_value(key);
+    }
+}
+
+Minimizer::Minimizer(size_t literals_count) :
+    _literals_count(literals_count),
+    _all((literals_count == 32) ? ~0u : ((1u << literals_count) - 1)),
+    _care(),
+    _on(),
+    _implicants(),
+    _primes(),
+    _cover(),
+    _cover_counts(),
+    _uncovered()
+{
+}
+
+Minimizer::Minimizer(size_t literals_count,
+                     const std::vector<unsigned int>& onValues,
+                     const std::vector<unsigned int>& dontCareValues) :
+    _literals_count(literals_count),
+    _all((literals_count == 32) ? ~0u : ((1u << literals_count) - 1)),
+    _care(),
+    _on(),
+    _implicants(),
+    _primes(),
+    _cover(),
+    _cover_counts(),
+    _uncovered()
+{
+    const std::vector<unsigned int>* sets[] = { &onValues, &dontCareValues };
+    for (size_t i = 0; i < 2; ++i) {
+        for (std::vector<unsigned int>::const_iterator it = sets[i]->begin(); it < sets[i]->end(); ++it) {
+            addCare(*it);
+        }
+    }
+
+    for (std::vector<unsigned int>::const_iterator it = onValues.begin(); it < onValues.end(); ++it) {
+        setOn(*it, true);
+    }
+
+    coverUncovered();
+}
+
+Minimizer::~Minimizer() {
+}
+
+size_t Minimizer::getLiteralsCount() const {
+    return _literals_count;
+}
+
+void Minimizer::addMinterm(unsigned int minterm) {
+    addCare(minterm);
+    setOn(minterm, true);
+    coverUncovered();
+}
+
+void Minimizer::removeMinterm(unsigned int minterm) {
+    setOn(minterm, false);
+    removeCare(minterm);
+    coverUncovered();
+}
+
+void Minimizer::setDontCare(unsigned int minterm) {
+    addCare(minterm);
+    setOn(minterm, false);
+    coverUncovered();
+}
+
+std::vector<Cube> Minimizer::getCover() const {
+    std::vector<Cube> cover;
+    for (CubeSet::const_iterator it = _cover.begin(); it != _cover.end(); ++it) {
+        cover.push_back(Cube(key_value(*it), key_dash_mask(*it)));
+    }
+
+    std::sort(cover.begin(), cover.end());
+    return cover;
+}
+
+size_t Minimizer::getImplicantsCount() const {
+    return _implicants.size();
+}
+
+size_t Minimizer::getPrimesCount() const {
+    return _primes.size();
+}
+
+bool Minimizer::isImplicant(unsigned int value, unsigned int dash_mask) const {
+    return _implicants.count(cube_key(value, dash_mask)) > 0;
+}
+
+bool Minimizer::isPrime(unsigned int value, unsigned int dash_mask) const {
+    for (unsigned int bits = _all & ~dash_mask; bits != 0; bits &= bits - 1) {
+        unsigned int bit = bits & -bits;
+        if (isImplicant(value & ~bit, dash_mask | bit)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Minimizer::implicantsHolding(unsigned int minterm, std::vector<uint64_t>& holding) const {
+    // every implicant holding minterm has a half one level down holding it
+    if (!isImplicant(minterm, 0)) {
+        return;
+    }
+
+    CubeSet seen;
+    holding.push_back(cube_key(minterm, 0));
+    for (size_t i = 0; i < holding.size(); ++i) {
+        unsigned int dash_mask = key_dash_mask(holding[i]);
+        for (unsigned int bits = _all & ~dash_mask; bits != 0; bits &= bits - 1) {
+            unsigned int bit = bits & -bits;
+            uint64_t key = cube_key(minterm, dash_mask | bit);
+            if (_implicants.count(key) && seen.insert(key).second) {
+                holding.push_back(key);
+            }
+        }
+    }
+}
+
+void Minimizer::addCare(unsigned int minterm) {
+    if (!_care.insert(minterm).second) {
+        return;
+    }
+
+    // a cube holding minterm is a new implicant iff its other half (which
+    // does not hold minterm) already was one; both halves stop being primes
+    std::vector<uint64_t> added(1, cube_key(minterm, 0));
+    std::vector<uint64_t> absorbed;
+    _implicants.insert(added.front());
+    for (size_t i = 0; i < added.size(); ++i) {
+        unsigned int value = key_value(added[i]);
+        unsigned int dash_mask = key_dash_mask(added[i]);
+        for (unsigned int bits = _all & ~dash_mask; bits != 0; bits &= bits - 1) {
+            unsigned int bit = bits & -bits;
+            if (!isImplicant(value ^ bit, dash_mask)) {
+                continue;
+            }
+
+            absorbed.push_back(cube_key(value ^ bit, dash_mask));
+            uint64_t key = cube_key(value, dash_mask | bit);
+            if (_implicants.insert(key).second) {
+                added.push_back(key);
+            }
+        }
+    }
+
+    for (std::vector<uint64_t>::iterator it = added.begin(); it < added.end(); ++it) {
+        updatePrime(*it);
+    }
+
+    for (std::vector<uint64_t>::iterator it = absorbed.begin(); it < absorbed.end(); ++it) {
+        updatePrime(*it);
+
+        // cover products stay primes: swap an absorbed one for a prime holding it
+        if (_cover.count(*it)) {
+            uint64_t prime = expand(*it);
+            addToCover(prime);
+            removeFromCover(*it);
+            dropRedundant(prime);
+        }
+    }
+}
+
+void Minimizer::removeCare(unsigned int minterm) {
+    if (!_care.erase(minterm)) {
+        return;
+    }
+
+    std::vector<uint64_t> removed;
+    implicantsHolding(minterm, removed);
+    for (std::vector<uint64_t>::iterator it = removed.begin(); it < removed.end(); ++it) {
+        _implicants.erase(*it);
+        _primes.erase(*it);
+        if (_cover.count(*it)) {
+            removeFromCover(*it);
+        }
+    }
+
+    // the halves without minterm of the removed implicants may be primes now
+    for (std::vector<uint64_t>::iterator it = removed.begin(); it < removed.end(); ++it) {
+        unsigned int value = key_value(*it);
+        unsigned int dash_mask = key_dash_mask(*it);
+        for (unsigned int bits = dash_mask; bits != 0; bits &= bits - 1) {
+            unsigned int bit = bits & -bits;
+            updatePrime(cube_key(value | (bit & ~minterm), dash_mask & ~bit));
+        }
+    }
+}
+
+void Minimizer::setOn(unsigned int minterm, bool on) {
+    if (on) {
+        if (!_on.insert(minterm).second) {
+            return;
+        }
+
+        size_t count = 0;
+        for (CubeSet::iterator it = _cover.begin(); it != _cover.end(); ++it) {
+            if (holds(*it, minterm)) {
+                count++;
+            }
+        }
+
+        _cover_counts[minterm] = count;
+        if (count == 0) {
+            _uncovered.push_back(minterm);
+        }
+
+        return;
+    }
+
+    if (!_on.erase(minterm)) {
+        return;
+    }
+
+    _cover_counts.erase(minterm);
+
+    // products holding minterm may have been there for it alone
+    std::vector<uint64_t> holding;
+    for (CubeSet::iterator it = _cover.begin(); it != _cover.end(); ++it) {
+        if (holds(*it, minterm)) {
+            holding.push_back(*it);
+        }
+    }
+
+    for (std::vector<uint64_t>::iterator it = holding.begin(); it < holding.end(); ++it) {
+        dropRedundant(*it);
+    }
+}
+
+void Minimizer::updatePrime(uint64_t key) {
+    if (_implicants.count(key) && isPrime(key_value(key), key_dash_mask(key))) {
+        _primes.insert(key);
+    } else {
+        _primes.erase(key);
+    }
+}
+
+uint64_t Minimizer::expand(uint64_t key) const {
+    unsigned int value = key_value(key);
+    unsigned int dash_mask = key_dash_mask(key);
+    for (unsigned int bits = _all & ~dash_mask; bits != 0; bits &= bits - 1) {
+        unsigned int bit = bits & -bits;
+        if (isImplicant(value & ~bit, dash_mask | bit)) {
+            value &= ~bit;
+            dash_mask |= bit;
+        }
+    }
+
+    return cube_key(value, dash_mask);
+}
+
+void Minimizer::addToCover(uint64_t key) {
+    if (!_cover.insert(key).second) {
+        return;
+    }
+
+    unsigned int value = key_value(key);
+    unsigned int dash_mask = key_dash_mask(key);
+    unsigned int offset = 0;
+    do {
+        std::tr1::unordered_map<unsigned int, size_t>::iterator count = _cover_counts.find(value | offset);
+        if (count != _cover_counts.end()) {
+            count->second++;
+        }
+
+        offset = (offset - dash_mask) & dash_mask;
+    } while (offset != 0);
+}
+
+void Minimizer::removeFromCover(uint64_t key) {
+    if (!_cover.erase(key)) {
+        return;
+    }
+
+    unsigned int value = key_value(key);
+    unsigned int dash_mask = key_dash_mask(key);
+    unsigned int offset = 0;
+    do {
+        std::tr1::unordered_map<unsigned int, size_t>::iterator count = _cover_counts.find(value | offset);
+        if (count != _cover_counts.end() && --count->second == 0) {
+            _uncovered.push_back(value | offset);
+        }
+
+        offset = (offset - dash_mask) & dash_mask;
+    } while (offset != 0);
+}
+
+void Minimizer::coverUncovered() {
+    // the minterms held by the fewest primes go first, so that essential
+    // primes are in before the products that would only overlap them
+    std::vector<std::pair<size_t, unsigned int> > pending;
+    for (std::vector<unsigned int>::iterator it = _uncovered.begin(); it < _uncovered.end(); ++it) {
+        std::vector<uint64_t> holding;
+        implicantsHolding(*it, holding);
+
+        size_t primes_count = 0;
+        for (std::vector<uint64_t>::iterator h_it = holding.begin(); h_it < holding.end(); ++h_it) {
+            primes_count += _primes.count(*h_it);
+        }
+
+        pending.push_back(std::make_pair(primes_count, *it));
+    }
+
+    _uncovered.clear();
+    std::sort(pending.begin(), pending.end());
+
+    for (size_t i = 0; i < pending.size(); ++i) {
+        unsigned int minterm = pending[i].second;
+        std::tr1::unordered_map<unsigned int, size_t>::iterator count = _cover_counts.find(minterm);
+        if (count == _cover_counts.end() || count->second > 0) {
+            continue;
+        }
+
+        // the prime holding minterm that covers the most uncovered ON
+        // minterms, the larger one on a tie
+        std::vector<uint64_t> holding;
+        implicantsHolding(minterm, holding);
+
+        uint64_t best = 0;
+        size_t best_gain = 0;
+        for (std::vector<uint64_t>::iterator it = holding.begin(); it < holding.end(); ++it) {
+            if (!_primes.count(*it)) {
+                continue;
+            }
+
+            size_t gain = 0;
+            unsigned int value = key_value(*it);
+            unsigned int dash_mask = key_dash_mask(*it);
+            unsigned int offset = 0;
+            do {
+                std::tr1::unordered_map<unsigned int, size_t>::iterator other = _cover_counts.find(value | offset);
+                if (other != _cover_counts.end() && other->second == 0) {
+                    gain++;
+                }
+
+                offset = (offset - dash_mask) & dash_mask;
+            } while (offset != 0);
+
+            if (gain > best_gain ||
+                (gain == best_gain && __builtin_popcount(dash_mask) > __builtin_popcount(key_dash_mask(best))))
+            {
+                best = *it;
+                best_gain = gain;
+            }
+        }
+
+        addToCover(best);
+
+        // products overlapping the new one may be redundant now
+        std::vector<uint64_t> overlapping;
+        for (CubeSet::iterator it = _cover.begin(); it != _cover.end(); ++it) {
+            unsigned int dashes = key_dash_mask(*it) | key_dash_mask(best);
+            if (*it != best && ((key_value(*it) ^ key_value(best)) & ~dashes) == 0) {
+                overlapping.push_back(*it);
+            }
+        }
+
+        for (std::vector<uint64_t>::iterator it = overlapping.begin(); it < overlapping.end(); ++it) {
+            dropRedundant(*it);
+        }
+    }
+}
+
+void Minimizer::dropRedundant(uint64_t key) {
+    if (!_cover.count(key)) {
+        return;
+    }
+
+    unsigned int value = key_value(key);
+    unsigned int dash_mask = key_dash_mask(key);
+    unsigned int offset = 0;
+    do {
+        std::tr1::unordered_map<unsigned int, size_t>::iterator count = _cover_counts.find(value | offset);
+        if (count != _cover_counts.end() && count->second < 2) {
+            return;
+        }
+
+        offset = (offset - dash_mask) & dash_mask;
+    } while (offset != 0);
+
+    removeFromCover(key);
+}
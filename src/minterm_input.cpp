@@ -0,0 +1,167 @@
+#include "../include/minterm_input.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    std::string token_error(const char* begin, const char* end, const std::string& message) {
+        return "'" + std::string(begin, end) + "': " + message;
+    }
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+}
+
+MintermReader::MintermReader(size_t literals_count) :
+    _literals_count(literals_count),
+    _max_minterm((literals_count == 32) ? ~0u : ((1u << literals_count) - 1)),
+    _bitmaps(),
+    _lists(SETS_COUNT)
+{
+    if (literals_count <= BITMAP_MAX_LITERALS) {
+        _bitmaps.assign(SETS_COUNT, Bitmap((size_t)1 << literals_count));
+    }
+}
+
+MintermReader::~MintermReader() {
+}
+
+void MintermReader::addToken(Set set, const std::string& token) {
+    addToken(set, token.data(), token.data() + token.size());
+}
+
+void MintermReader::addToken(Set set, const char* begin, const char* end) {
+    const char* position = begin;
+    while (position < end) {
+        unsigned int first = parseNumber(position, end, begin);
+        unsigned int last = first;
+        unsigned int stride = 1;
+
+        if (position < end && *position == '-') {
+            position++;
+            last = parseNumber(position, end, begin);
+            if (last < first) {
+                throw std::runtime_error(token_error(begin, end, "range goes backwards"));
+            }
+
+            if (position < end && *position == ':') {
+                position++;
+                stride = parseNumber(position, end, begin);
+                if (stride == 0) {
+                    throw std::runtime_error(token_error(begin, end, "stride must be positive"));
+                }
+            }
+        }
+
+        if (position < end) {
+            if (*position != ',') {
+                throw std::runtime_error(token_error(begin, end, "expected a minterm, range or ','"));
+            }
+
+            position++;
+        }
+
+        if (last > _max_minterm) {
+            std::stringstream message;
+            message << "minterm " << last << " does not fit in " << _literals_count << " literals";
+            throw std::runtime_error(token_error(begin, end, message.str()));
+        }
+
+        for (unsigned int minterm = first; ; minterm += stride) {
+            add(set, minterm);
+            if (last - minterm < stride) {
+                break;
+            }
+        }
+    }
+}
+
+unsigned int MintermReader::parseNumber(const char*& position, const char* end, const char* token_begin) const {
+    if (position == end || *position < '0' || *position > '9') {
+        throw std::runtime_error(token_error(token_begin, end, "expected a number"));
+    }
+
+    unsigned long long value = 0;
+    for (; position < end && *position >= '0' && *position <= '9'; ++position) {
+        value = value * 10 + (*position - '0');
+        if (value > 0xffffffffULL) {
+            throw std::runtime_error(token_error(token_begin, end, "number too large"));
+        }
+    }
+
+    return value;
+}
+
+void MintermReader::add(Set set, unsigned int minterm) {
+    if (!_bitmaps.empty()) {
+        _bitmaps[set].set(minterm);
+    } else {
+        _lists[set].push_back(minterm);
+    }
+}
+
+void MintermReader::read(std::istream& input) {
+    Set set = SOP;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(input, line)) {
+        line_number++;
+
+        const char* position = line.data();
+        const char* end = position + line.size();
+        while (position < end) {
+            while (position < end && is_space(*position)) {
+                position++;
+            }
+
+            if (position == end || *position == '#') {
+                break;
+            }
+
+            const char* token_end = position;
+            while (token_end < end && !is_space(*token_end) && *token_end != '#') {
+                token_end++;
+            }
+
+            std::string keyword(position, token_end);
+            try {
+                if (keyword == "sop") {
+                    set = SOP;
+                } else if (keyword == "pos") {
+                    set = POS;
+                } else if (keyword == "dc" || keyword == "dont-care") {
+                    set = DONT_CARE;
+                } else if (keyword == "off") {
+                    set = OFF;
+                } else {
+                    addToken(set, position, token_end);
+                }
+            } catch (std::runtime_error& e) {
+                std::stringstream message;
+                message << "input line " << line_number << ": " << e.what();
+                throw std::runtime_error(message.str());
+            }
+
+            position = token_end;
+        }
+    }
+}
+
+void MintermReader::getValues(Set set, std::vector<unsigned int>& values) const {
+    if (_bitmaps.empty()) {
+        std::vector<unsigned int> sorted(_lists[set]);
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+        values.insert(values.end(), sorted.begin(), sorted.end());
+        return;
+    }
+
+    const std::vector<uint64_t>& words = _bitmaps[set].getWords();
+    for (size_t w = 0; w < words.size(); ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            values.push_back(w * 64 + __builtin_ctzll(bits));
+        }
+    }
+}
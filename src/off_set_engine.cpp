@@ -0,0 +1,99 @@
+#include "../include/off_set_engine.h"
+
+#include <algorithm>
+#include <tr1/unordered_set>
+#include <stdint.h>
+
+namespace {
+    uint64_t cube_key(unsigned int value, unsigned int dash_mask) {
+        return ((uint64_t)dash_mask << 32) | value;
+    }
+
+    struct PopcountCompare {
+        bool operator()(unsigned int first, unsigned int second) const {
+            return __builtin_popcount(first) < __builtin_popcount(second);
+        }
+    };
+
+    // keeps the sets no other set is a proper subset of (sets sorted by size)
+    void keep_minimal(std::vector<unsigned int>& sets) {
+        std::vector<unsigned int> minimal;
+        for (std::vector<unsigned int>::iterator it = sets.begin(); it < sets.end(); ++it) {
+            bool dominated = false;
+            for (std::vector<unsigned int>::iterator kept = minimal.begin(); kept < minimal.end(); ++kept) {
+                if ((*kept & *it) == *kept) {
+                    dominated = true;
+                    break;
+                }
+            }
+
+            if (!dominated) {
+                minimal.push_back(*it);
+            }
+        }
+
+        sets.swap(minimal);
+    }
+
+    /**
+     * Berge's algorithm: the minimal hitting sets of the sets seen so far,
+     * extended one set at a time. A hitting set that misses the new set is
+     * replaced by its extensions with each of the set's elements.
+     */
+    void hitting_sets(const std::vector<unsigned int>& sets, std::vector<unsigned int>& hitting) {
+        hitting.assign(1, 0);
+        std::vector<unsigned int> next;
+        for (std::vector<unsigned int>::const_iterator set = sets.begin(); set < sets.end(); ++set) {
+            next.clear();
+            for (std::vector<unsigned int>::iterator it = hitting.begin(); it < hitting.end(); ++it) {
+                if (*it & *set) {
+                    next.push_back(*it);
+                    continue;
+                }
+
+                for (unsigned int bits = *set; bits != 0; bits &= bits - 1) {
+                    next.push_back(*it | (bits & -bits));
+                }
+            }
+
+            std::sort(next.begin(), next.end());
+            next.erase(std::unique(next.begin(), next.end()), next.end());
+            std::stable_sort(next.begin(), next.end(), PopcountCompare());
+            keep_minimal(next);
+            hitting.swap(next);
+        }
+    }
+}
+
+void off_set_terms(const std::vector<unsigned int>& onValues,
+                   const std::vector<unsigned int>& offValues,
+                   size_t literals_count, Terms& terms, Terms& primeTerms)
+{
+    unsigned int all = (literals_count == 32) ? ~0u : ((1u << literals_count) - 1);
+    std::tr1::unordered_set<uint64_t> primes;
+    std::vector<unsigned int> differences;
+    std::vector<unsigned int> hitting;
+    for (std::vector<unsigned int>::const_iterator on = onValues.begin(); on < onValues.end(); ++on) {
+        differences.clear();
+        for (std::vector<unsigned int>::const_iterator off = offValues.begin(); off < offValues.end(); ++off) {
+            differences.push_back(*on ^ *off);
+        }
+
+        // the smallest differences first: they prune the most
+        std::sort(differences.begin(), differences.end());
+        differences.erase(std::unique(differences.begin(), differences.end()), differences.end());
+        std::stable_sort(differences.begin(), differences.end(), PopcountCompare());
+        keep_minimal(differences);
+
+        hitting_sets(differences, hitting);
+        for (std::vector<unsigned int>::iterator it = hitting.begin(); it < hitting.end(); ++it) {
+            unsigned int dash_mask = all & ~*it;
+            unsigned int value = *on & *it;
+            if (primes.insert(cube_key(value, dash_mask)).second) {
+                Term* term = new Term(value, dash_mask, literals_count);
+                terms.push_back(term); // add to heap pointers vector
+                primeTerms.push_back(term);
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+#include "../include/perf_counters.h"
+#include "../include/deadline.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace {
+    const char* COUNTER_NAMES[PerfCounters::COUNTERS_COUNT] = {
+        "cycles",
+        "instructions",
+        "cache-misses",
+        "branch-misses"
+    };
+
+    const uint64_t COUNTER_CONFIGS[PerfCounters::COUNTERS_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    int open_counter(uint64_t config) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // worker threads (pipelined, shannon, --portfolio, --best-form)
+        // count too: their counts are added to ours when they exit
+        attr.inherit = 1;
+
+        return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+}
+
+PerfCounters::PerfCounters() :
+    _fds(),
+    _unavailable_reason(),
+    _phases(),
+    _running(false),
+    _phase_start(0)
+{
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        _fds[i] = open_counter(COUNTER_CONFIGS[i]);
+        if (_fds[i] < 0 && _unavailable_reason.empty()) {
+            _unavailable_reason = std::string(COUNTER_NAMES[i]) + ": " + std::strerror(errno);
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        if (_fds[i] >= 0) {
+            close(_fds[i]);
+        }
+    }
+}
+
+bool PerfCounters::isAvailable() const {
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        if (_fds[i] >= 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool PerfCounters::isAvailable(Counter counter) const {
+    return _fds[counter] >= 0;
+}
+
+std::string PerfCounters::getUnavailableReason() const {
+    return _unavailable_reason;
+}
+
+void PerfCounters::startPhase(const std::string& name) {
+    if (_running) {
+        stopPhase();
+    }
+
+    _phases.push_back(Phase(name));
+
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        if (_fds[i] >= 0) {
+            ioctl(_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    _running = true;
+    _phase_start = Deadline::now();
+}
+
+void PerfCounters::stopPhase() {
+    if (!_running) {
+        return;
+    }
+
+    Phase& phase = _phases.back();
+    phase.wall_ms = Deadline::now() - _phase_start;
+
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        if (_fds[i] < 0) {
+            continue;
+        }
+
+        ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+
+        uint64_t value = 0;
+        if (read(_fds[i], &value, sizeof(value)) == sizeof(value)) {
+            phase.values[i] = value;
+        }
+    }
+
+    _running = false;
+}
+
+void PerfCounters::report(std::ostream& output, size_t implicants_count) const {
+    output << "perf: " << implicants_count << " implicants" << std::endl;
+    if (!isAvailable()) {
+        output << "perf: hardware counters unavailable (" << _unavailable_reason
+               << "), reporting wall time only" << std::endl;
+    }
+
+    output << std::left << std::setw(10) << "phase"
+           << std::right << std::setw(12) << "wall(ms)";
+    for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+        output << std::setw(16) << COUNTER_NAMES[i];
+    }
+    output << std::setw(8) << "IPC"
+           << std::setw(18) << "cache-miss/impl"
+           << std::setw(18) << "branch-miss/impl" << std::endl;
+
+    for (std::vector<Phase>::const_iterator it = _phases.begin();
+         it < _phases.end(); ++it)
+    {
+        output << std::left << std::setw(10) << it->name
+               << std::right << std::setw(12) << std::fixed << std::setprecision(3) << it->wall_ms;
+
+        for (size_t i = 0; i < COUNTERS_COUNT; ++i) {
+            if (_fds[i] >= 0) {
+                output << std::setw(16) << it->values[i];
+            } else {
+                output << std::setw(16) << "n/a";
+            }
+        }
+
+        output << std::setprecision(2);
+        if (_fds[CYCLES] >= 0 && _fds[INSTRUCTIONS] >= 0 && it->values[CYCLES] > 0) {
+            output << std::setw(8) << (double)it->values[INSTRUCTIONS] / it->values[CYCLES];
+        } else {
+            output << std::setw(8) << "n/a";
+        }
+
+        Counter per_implicant[] = { CACHE_MISSES, BRANCH_MISSES };
+        for (size_t i = 0; i < 2; ++i) {
+            if (_fds[per_implicant[i]] >= 0 && implicants_count > 0) {
+                output << std::setw(18) << (double)it->values[per_implicant[i]] / implicants_count;
+            } else {
+                output << std::setw(18) << "n/a";
+            }
+        }
+
+        output << std::endl;
+    }
+}
@@ -0,0 +1,350 @@
+#include "../include/pipeline.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+#include <stdint.h>
+
+namespace {
+    uint64_t cube_key(unsigned int value, unsigned int dash_mask) {
+        return ((uint64_t)dash_mask << 32) | value;
+    }
+
+    /**
+     * The implicants of one level (dash count) and popcount. A group is
+     * written only by the task producing it, and read only once it is final.
+     * merged_up is set by the task merging it with the group above, and
+     * merged_down by the task merging the group below with it, so no flag is
+     * written by two tasks.
+     */
+    struct Group {
+        Group() :
+            terms(),
+            values(),
+            masks(),
+            merged_up(),
+            merged_down(),
+            final(false),
+            emitted(false)
+        {
+        }
+
+        void add(Term* term, unsigned int value, unsigned int dash_mask) {
+            terms.push_back(term);
+            values.push_back(value);
+            masks.push_back(dash_mask);
+        }
+
+        void close() {
+            merged_up.assign(terms.size(), 0);
+            merged_down.assign(terms.size(), 0);
+            final = true;
+        }
+
+        Terms terms;
+        std::vector<unsigned int> values;
+        std::vector<unsigned int> masks;
+        std::vector<char> merged_up;
+        std::vector<char> merged_down;
+        bool final;
+        bool emitted;
+    };
+
+    class Pipeline {
+        public:
+            Pipeline(Terms& terms, size_t literals_count) :
+                _literals_count(literals_count),
+                _groups((literals_count + 1) * (literals_count + 1)),
+                _task_done(literals_count * literals_count, 0),
+                _task_queued(literals_count * literals_count, 0),
+                _queue(),
+                _primes(),
+                _mutex(),
+                _work_ready(),
+                _primes_ready(),
+                _tasks_left(literals_count * literals_count),
+                _groups_left((literals_count + 1) * (literals_count + 1)),
+                _aborted(false),
+                _error()
+            {
+                std::tr1::unordered_set<unsigned int> seen;
+                for (Terms::iterator it = terms.begin(); it < terms.end(); ++it) {
+                    unsigned int value = (*it)->getDecimal();
+                    if (seen.insert(value).second) {
+                        group(0, __builtin_popcount(value)).add(*it, value, 0);
+                    }
+                }
+
+                // the input level is final, and so is the (always empty) top
+                // popcount group of every other level, which nothing produces
+                for (size_t popcount = 0; popcount <= _literals_count; ++popcount) {
+                    group(0, popcount).close();
+                }
+
+                for (size_t level = 1; level <= _literals_count; ++level) {
+                    group(level, _literals_count).close();
+                }
+            }
+
+            void run(Terms& primeTerms, CoverChart& chart, size_t threads_count) {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    for (size_t popcount = 0; popcount < _literals_count; ++popcount) {
+                        schedule(0, popcount);
+                    }
+
+                    for (size_t popcount = 0; popcount <= _literals_count; ++popcount) {
+                        emitIfReady(_literals_count, popcount);
+                    }
+                }
+
+                std::vector<std::thread> workers;
+                for (size_t i = 0; i < threads_count; ++i) {
+                    workers.push_back(std::thread(&Pipeline::work, this));
+                }
+
+                // the chart is filled on this thread while the workers merge
+                bool done = false;
+                while (!done) {
+                    Terms batch;
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        while (_primes.empty() && _groups_left > 0 && !_aborted) {
+                            _primes_ready.wait(lock);
+                        }
+
+                        batch.swap(_primes);
+                        done = (_groups_left == 0 || _aborted);
+                    }
+
+                    try {
+                        for (Terms::iterator it = batch.begin(); it < batch.end(); ++it) {
+                            chart.addPrime(*it);
+                            primeTerms.push_back(*it);
+                        }
+                    } catch (...) {
+                        abort(std::current_exception());
+                        done = true;
+                    }
+                }
+
+                for (std::vector<std::thread>::iterator it = workers.begin();
+                     it < workers.end(); ++it)
+                {
+                    it->join();
+                }
+
+                if (_error) {
+                    std::rethrow_exception(_error);
+                }
+            }
+
+            // hands every implicant created by the workers over to terms
+            void release(Terms& terms) {
+                for (size_t level = 1; level <= _literals_count; ++level) {
+                    for (size_t popcount = 0; popcount <= _literals_count; ++popcount) {
+                        Terms& created = group(level, popcount).terms;
+                        terms.insert(terms.end(), created.begin(), created.end());
+                        created.clear();
+                    }
+                }
+            }
+
+        private:
+            Pipeline(const Pipeline&);
+
+            Pipeline& operator=(const Pipeline&);
+
+            Group& group(size_t level, size_t popcount) {
+                return _groups[level * (_literals_count + 1) + popcount];
+            }
+
+            size_t task(size_t level, size_t popcount) const {
+                return level * _literals_count + popcount;
+            }
+
+            void abort(std::exception_ptr error) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                if (!_error) {
+                    _error = error;
+                }
+
+                _aborted = true;
+                _work_ready.notify_all();
+                _primes_ready.notify_all();
+            }
+
+            void work() {
+                for (;;) {
+                    std::pair<size_t, size_t> next;
+                    {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        while (_queue.empty() && _tasks_left > 0 && !_aborted) {
+                            _work_ready.wait(lock);
+                        }
+
+                        if (_aborted || _queue.empty()) {
+                            return;
+                        }
+
+                        next = _queue.front();
+                        _queue.pop_front();
+                    }
+
+                    try {
+                        merge(next.first, next.second);
+                    } catch (...) {
+                        abort(std::current_exception());
+                        return;
+                    }
+
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    finish(next.first, next.second);
+                }
+            }
+
+            // merges group (level, popcount) with (level, popcount + 1) into
+            // (level + 1, popcount), without holding the lock
+            void merge(size_t level, size_t popcount) {
+                Group& lower = group(level, popcount);
+                Group& upper = group(level, popcount + 1);
+                Group& merged = group(level + 1, popcount);
+                if (lower.terms.empty() || upper.terms.empty()) {
+                    return;
+                }
+
+                std::tr1::unordered_map<uint64_t, size_t> upper_index;
+                for (size_t i = 0; i < upper.terms.size(); ++i) {
+                    upper_index[cube_key(upper.values[i], upper.masks[i])] = i;
+                }
+
+                // the same cube comes out of several pairs (0,1-8,9 and 0,8-1,9)
+                std::tr1::unordered_set<uint64_t> created;
+                unsigned int all = (_literals_count == 32) ? ~0u : ((1u << _literals_count) - 1);
+                for (size_t i = 0; i < lower.terms.size(); ++i) {
+                    unsigned int value = lower.values[i];
+                    unsigned int dash_mask = lower.masks[i];
+                    unsigned int zeros = all & ~value & ~dash_mask;
+                    for (unsigned int bits = zeros; bits != 0; bits &= bits - 1) {
+                        unsigned int bit = bits & -bits;
+                        std::tr1::unordered_map<uint64_t, size_t>::iterator position =
+                            upper_index.find(cube_key(value | bit, dash_mask));
+                        if (position == upper_index.end()) {
+                            continue;
+                        }
+
+                        size_t j = position->second;
+                        lower.merged_up[i] = 1;
+                        upper.merged_down[j] = 1;
+
+                        if (!created.insert(cube_key(value, dash_mask | bit)).second) {
+                            continue;
+                        }
+
+                        Term* term = new Term(value, dash_mask | bit, _literals_count);
+                        merged.add(term, value, dash_mask | bit);
+                        if (lower.terms[i]->isDontCare() && upper.terms[j]->isDontCare()) {
+                            term->dontCare();
+                        }
+                    }
+                }
+            }
+
+            void schedule(size_t level, size_t popcount) {
+                if (level >= _literals_count || popcount >= _literals_count ||
+                    _task_queued[task(level, popcount)] ||
+                    !group(level, popcount).final || !group(level, popcount + 1).final)
+                {
+                    return;
+                }
+
+                _task_queued[task(level, popcount)] = 1;
+                _queue.push_back(std::make_pair(level, popcount));
+                _work_ready.notify_one();
+            }
+
+            void finish(size_t level, size_t popcount) {
+                _task_done[task(level, popcount)] = 1;
+                _tasks_left--;
+
+                group(level + 1, popcount).close();
+                if (popcount > 0) {
+                    schedule(level + 1, popcount - 1);
+                }
+                schedule(level + 1, popcount);
+
+                emitIfReady(level, popcount);
+                emitIfReady(level, popcount + 1);
+                emitIfReady(level + 1, popcount);
+
+                if (_tasks_left == 0) {
+                    _work_ready.notify_all();
+                }
+            }
+
+            // a final group whose merge tasks (below and above) are done
+            // holds no more unmerged candidates: its unmerged ones are prime
+            void emitIfReady(size_t level, size_t popcount) {
+                Group& current = group(level, popcount);
+                if (!current.final || current.emitted) {
+                    return;
+                }
+
+                if (level < _literals_count) {
+                    if (popcount > 0 && !_task_done[task(level, popcount - 1)]) {
+                        return;
+                    }
+
+                    if (popcount < _literals_count && !_task_done[task(level, popcount)]) {
+                        return;
+                    }
+                }
+
+                for (size_t i = 0; i < current.terms.size(); ++i) {
+                    if (!current.merged_up[i] && !current.merged_down[i] &&
+                        !current.terms[i]->isDontCare())
+                    {
+                        _primes.push_back(current.terms[i]);
+                    }
+                }
+
+                current.emitted = true;
+                _groups_left--;
+                _primes_ready.notify_one();
+            }
+
+            size_t _literals_count;
+            std::vector<Group> _groups;
+            std::vector<char> _task_done;
+            std::vector<char> _task_queued;
+            std::deque<std::pair<size_t, size_t> > _queue;
+            Terms _primes;
+            std::mutex _mutex;
+            std::condition_variable _work_ready;
+            std::condition_variable _primes_ready;
+            size_t _tasks_left;
+            size_t _groups_left;
+            bool _aborted;
+            std::exception_ptr _error;
+    };
+}
+
+void pipelined_terms(Terms& terms, Terms& primeTerms, CoverChart& chart, size_t threads_count) {
+    if (terms.empty()) {
+        return;
+    }
+
+    Pipeline pipeline(terms, terms.front()->getLiteralCount());
+    try {
+        pipeline.run(primeTerms, chart, threads_count > 0 ? threads_count : 1);
+    } catch (...) {
+        pipeline.release(terms);
+        throw;
+    }
+
+    pipeline.release(terms);
+}
@@ -10,22 +10,50 @@
 */
 
 #include <vector>
-#include <queue>
-#include <tr1/unordered_map>
 #include <iostream>
+#include <fstream>
 #include <ostream>
 #include <string>
+#include <sstream>
 #include <cstdlib>
 #include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <algorithm>
+#include <iterator>
 #include <boost/program_options.hpp>
 #include <boost/foreach.hpp>
 
 #include "../include/binary.h"
 #include "../include/term.h"
+#include "../include/perf_counters.h"
+#include "../include/bitmap.h"
+#include "../include/memory_budget.h"
+#include "../include/combine.h"
+#include "../include/cover.h"
+#include "../include/deadline.h"
+#include "../include/heuristic.h"
+#include "../include/zdd_engine.h"
+#include "../include/consensus.h"
+#include "../include/cube_input.h"
+#include "../include/pipeline.h"
+#include "../include/ternary_engine.h"
+#include "../include/shannon_engine.h"
+#include "../include/engine_selector.h"
+#include "../include/cover_table.h"
+#include "../include/cover_evaluator.h"
+#include "../include/code_emitter.h"
+#include "../include/minterm_input.h"
+#include "../include/minimizer.h"
+#include "../include/support.h"
+#include "../include/checkpoint.h"
+#include "../include/external_combine.h"
+#include "../include/off_set_engine.h"
+#include "../include/symmetric_engine.h"
 
 
-typedef std::vector<Term*> Terms;
-typedef std::tr1::unordered_map<size_t, Terms> ImplicantsMap;
 
 std::string terms_function(const std::vector<Term*>& terms, bool debug=false) {
     std::string minimized_function;
@@ -55,6 +83,101 @@ std::string terms_function(const std::vector<Term*>& terms, bool debug=false) {
     return minimized_function;
 }
 
+std::string terms_pos_function(const Terms& terms, bool debug=false) {
+    // each cube of the OFF-set cover is one sum, with its literals negated
+    std::string minimized_function;
+    for (Terms::const_iterator it = terms.begin();
+         it < terms.end(); ++it)
+    {
+        std::string expression = (*it)->getExpression();
+        std::string sum;
+        size_t literals = 0;
+        for (size_t i = 0; i < (*it)->getLiteralCount(); ++i) {
+            char c = (i < expression.length()) ? expression.at(i) : '0';
+            if (c == '-') {
+                continue;
+            }
+
+            sum.append(literals++ > 0 ? " + " : "");
+            sum += (char)(i + 'a');
+            if (c == '1') {
+                sum += '\'';
+            }
+        }
+
+        if (literals == 0) {
+            sum = "0"; // the cube of every minterm, f = 0
+        }
+
+        minimized_function.append(literals <= 1 ? sum : "(" + sum + ")");
+
+        if (debug) {
+            minimized_function.append(" (");
+            minimized_function.append((*it)->getDecimals());
+            minimized_function.append(")");
+        }
+    }
+
+    return minimized_function;
+}
+
+size_t cover_literals(const Terms& terms) {
+    size_t literals = 0;
+    for (Terms::const_iterator it = terms.begin();
+         it < terms.end(); ++it)
+    {
+        literals += (*it)->getLiteralCount() - __builtin_popcount((*it)->getDashMask());
+    }
+
+    return literals;
+}
+
+void delete_terms(Terms& terms) {
+    for (Terms::iterator it = terms.begin(); 
+         it < terms.end(); ++it) 
+    {
+        delete (*it);
+        *it = 0;
+    }
+}
+
+std::string cubes_function(const std::vector<Cube>& cubes, size_t literals_count) {
+    std::string minimized_function;
+    for (std::vector<Cube>::const_iterator it = cubes.begin();
+         it < cubes.end(); ++it)
+    {
+        if (it != cubes.begin()) {
+            minimized_function.append(" + ");
+        }
+
+        for (size_t i = 0; i < literals_count; ++i) {
+            unsigned int bit = 1u << (literals_count - i - 1);
+            if (it->second & bit) {
+                continue;
+            }
+
+            minimized_function += (char)(i + 'a');
+            if (!(it->first & bit)) {
+                minimized_function += '\'';
+            }
+        }
+    }
+
+    return minimized_function;
+}
+
+std::vector<Cube> terms_cubes(const Terms& terms) {
+    std::vector<Cube> cubes;
+    for (Terms::const_iterator it = terms.begin();
+         it < terms.end(); ++it)
+    {
+        unsigned int dash_mask = (*it)->getDashMask();
+        cubes.push_back(Cube((*it)->getDecimal() & ~dash_mask, dash_mask));
+    }
+
+    return cubes;
+}
+
 std::ostream& operator<<(std::ostream& output, const std::vector<std::string>& list) {
     if (list.size() > 0) {
         output << list.at(0);
@@ -83,20 +206,801 @@ std::ostream& operator<<(std::ostream& output, const Terms& terms) {
     return output;
 }
 
+/**
+ * How minimize() runs: the engine and the options it honours.
+ */
+struct Settings {
+    Settings() :
+        engine(),
+        literals_count(0),
+        prune_dont_cares(false),
+        threads_count(1),
+        debug(false),
+        reduce_support(true),
+        stats(false),
+        budget_fallback(),
+        spill_directory(),
+        off_set(false),
+        portfolio(false),
+        deadline_ms(0)
+    {
+    }
+
+    std::string engine;
+    size_t literals_count;
+    bool prune_dont_cares;
+    size_t threads_count;
+    bool debug;
+    bool reduce_support;
+    bool stats;
+    std::string budget_fallback;
+    std::string spill_directory; // tabular engine: combine out of core
+    bool off_set; // --off: the Dont-Cares are whatever is neither ON nor OFF
+    bool portfolio; // --deadline searches run threads_count strategies at once
+    double deadline_ms; // the cover search's budget, counted from the cover phase (0 = none)
+};
+
+/**
+ * A function to minimize, as minterms and cubes. The cube engines take the
+ * cubes as they are, the others expand them into the values. offValues is
+ * only set with --off, which leaves the Dont-Cares implicit.
+ */
+struct Function {
+    Function() :
+        onValues(),
+        dontCareValues(),
+        onCubes(),
+        dontCareCubes(),
+        offValues()
+    {
+    }
+
+    std::vector<unsigned int> onValues;
+    std::vector<unsigned int> dontCareValues;
+    std::vector<Cube> onCubes;
+    std::vector<Cube> dontCareCubes;
+    std::vector<unsigned int> offValues;
+};
+
+/**
+ * What minimize() found: the cover and, in terms, every Term it created.
+ */
+struct Minimization {
+    Minimization() :
+        terms(),
+        primeImplicants(),
+        coverResult(),
+        exact(true),
+        searched(false),
+        aborted(false)
+    {
+    }
+
+    Terms terms;
+    Terms primeImplicants;
+    CoverResult coverResult;
+    bool exact;
+    bool searched;
+    bool aborted; // the budget ran out and --budget-fallback is abort
+};
+
+/**
+ * Prime generation with the chosen engine followed by the cover phase. A
+ * checkpoint (tabular engine only) saves the progress, or resumes it.
+ */
+void minimize(const Settings& settings, Function& function, PerfCounters* perfCounters,
+              Minimization& result, Checkpoint* checkpoint = 0)
+{
+    std::string engine = settings.engine;
+    size_t literals_count = settings.literals_count;
+    bool prune_dont_cares = settings.prune_dont_cares;
+    size_t threads_count = settings.threads_count;
+    bool debug = settings.debug;
+    bool deadline_set = settings.deadline_ms > 0;
+    MemoryBudget& budget = MemoryBudget::instance();
+
+    std::vector<unsigned int>& onValues = function.onValues;
+    std::vector<unsigned int>& dontCareValues = function.dontCareValues;
+    std::vector<Cube>& onCubes = function.onCubes;
+    std::vector<Cube>& dontCareCubes = function.dontCareCubes;
+
+    Terms& terms = result.terms;
+    Terms& primeImplicants = result.primeImplicants;
+    CoverResult& coverResult = result.coverResult;
+    bool& exact = result.exact;
+    bool& searched = result.searched;
+
+    // with --off the primes come from the OFF-set, and only the ON minterms
+    // are rows of the chart: the Dont-Cares are never enumerated
+    if (settings.off_set) {
+        expand_cubes(onCubes, onValues);
+        onCubes.clear();
+
+        try {
+            if (perfCounters) {
+                perfCounters->startPhase("off-set");
+            }
+
+            Terms primeTerms;
+            off_set_terms(onValues, function.offValues, literals_count, terms, primeTerms);
+
+            if (perfCounters) {
+                perfCounters->startPhase("cover");
+            }
+
+            CoverChart chart(onValues);
+            for (Terms::iterator it = primeTerms.begin(); it < primeTerms.end(); ++it) {
+                chart.addPrime(*it);
+            }
+
+            primeImplicants = chart_cover(chart);
+            if (deadline_set) {
+                Deadline deadline(settings.deadline_ms);
+                coverResult = settings.portfolio
+                              ? portfolio_chart_cover(chart, primeImplicants, deadline, threads_count)
+                              : search_chart_cover(chart, primeImplicants, deadline);
+                primeImplicants = coverResult.cover;
+                searched = true;
+            }
+        } catch (std::bad_alloc& e) {
+            std::cerr << "qmc: " << e.what() << " (peak " << budget.getPeakBytes()
+                      << " bytes)" << std::endl;
+            result.aborted = true;
+        }
+
+        return;
+    }
+
+    // variables f does not depend on are dropped, and dashed in the cover
+    if (settings.reduce_support && onCubes.empty() && dontCareCubes.empty() &&
+        literals_count > 1 && literals_count <= MintermReader::BITMAP_MAX_LITERALS)
+    {
+        if (perfCounters) {
+            perfCounters->startPhase("support");
+        }
+
+        Bitmap onSet((size_t)1 << literals_count);
+        Bitmap dontCareSet((size_t)1 << literals_count);
+        for (std::vector<unsigned int>::iterator it = onValues.begin();
+             it < onValues.end(); ++it)
+        {
+            onSet.set(*it);
+        }
+
+        for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+             it < dontCareValues.end(); ++it)
+        {
+            dontCareSet.set(*it);
+        }
+
+        unsigned int vacuous = drop_vacuous_variables(onSet, dontCareSet, literals_count);
+        if (vacuous != 0) {
+            if (debug) {
+                std::cerr << "support: dropped " << __builtin_popcount(vacuous)
+                          << " vacuous variables" << std::endl;
+            }
+
+            Settings reducedSettings(settings);
+            reducedSettings.literals_count -= __builtin_popcount(vacuous);
+            reducedSettings.reduce_support = false;
+
+            Function reduced;
+            reduced_values(onSet, vacuous, reduced.onValues);
+            reduced_values(dontCareSet, vacuous, reduced.dontCareValues);
+            minimize(reducedSettings, reduced, perfCounters, result, checkpoint);
+            if (result.aborted) {
+                return;
+            }
+
+            Terms cover;
+            for (Terms::iterator it = primeImplicants.begin();
+                 it < primeImplicants.end(); ++it)
+            {
+                unsigned int dash_mask = (*it)->getDashMask();
+                Cube cube = spread_cube(Cube((*it)->getDecimal() & ~dash_mask, dash_mask),
+                                        vacuous, literals_count);
+                Term* term = new Term(cube.first, cube.second, literals_count);
+                terms.push_back(term); // add to heap pointers vector
+                cover.push_back(term);
+            }
+
+            primeImplicants = cover;
+            return;
+        }
+    }
+
+    // --engine auto chooses from cheap statistics of the (reduced) function,
+    // and may have the cover searched for exactly; --stats shows them
+    bool search = false;
+    if (engine == "auto" || settings.stats) {
+        FunctionStats stats(onValues, dontCareValues, onCubes.size() + dontCareCubes.size(), literals_count);
+        if (engine == "auto" && prune_dont_cares) {
+            engine = "tabular";
+        } else if (engine == "auto") {
+            engine = select_engine(stats, budget.getImplicantsLimit(sizeof(Term)),
+                                   settings.budget_fallback == "heuristic", search);
+            search = search && !deadline_set;
+
+            // symmetric functions have their primes counted, not estimated
+            if (engine != "tabular" && engine != "consensus" &&
+                literals_count <= MintermReader::BITMAP_MAX_LITERALS)
+            {
+                Bitmap onSet((size_t)1 << literals_count);
+                Bitmap dontCareSet((size_t)1 << literals_count);
+                for (std::vector<unsigned int>::iterator it = onValues.begin();
+                     it < onValues.end(); ++it)
+                {
+                    onSet.set(*it);
+                }
+
+                for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                     it < dontCareValues.end(); ++it)
+                {
+                    dontCareSet.set(*it);
+                }
+
+                SymmetricFunction symmetric(onSet, dontCareSet, literals_count);
+                if (symmetric.isSymmetric() && symmetric.isTractable() &&
+                    symmetric.getPrimesCount() <= AUTO_EXACT_IMPLICANTS)
+                {
+                    engine = "symmetric";
+                    search = !deadline_set;
+                }
+            }
+
+            if (deadline_set && (engine == "zdd" || engine == "heuristic")) {
+                std::cerr << "qmc: the " << engine << " engine builds no prime chart, "
+                          << "--deadline is ignored" << std::endl;
+            }
+        }
+
+        if (settings.stats) {
+            std::ostringstream line;
+            line << "stats: ";
+            stats.print(line);
+            line << " -> " << engine << (settings.engine == "auto" ? "" : " (explicit)")
+                 << (search ? ", exact cover" : "");
+            std::cerr << line.str() << std::endl;
+        }
+    }
+
+    // small functions are served from the precomputed table, unless an
+    // engine was asked for explicitly
+    bool table = engine == "tabular" && settings.engine == "auto" && !prune_dont_cares &&
+                 (size_t)literals_count <= COVER_TABLE_MAX_LITERALS;
+
+    // cube input seeds the tabular levels instead of being expanded
+    bool seeded = engine == "tabular" && !prune_dont_cares && !table && !checkpoint &&
+                  settings.spill_directory.empty() && (!onCubes.empty() || !dontCareCubes.empty());
+
+    if (engine != "consensus" && !seeded) {
+        // minterm engines need the cubes spelled out
+        expand_cubes(onCubes, onValues);
+        expand_cubes(dontCareCubes, dontCareValues);
+        onCubes.clear();
+        dontCareCubes.clear();
+    }
+
+    Terms dontCareTerms;
+    Terms primeTerms;
+    bool covered = false;
+
+    try {
+        if (table) {
+            primeImplicants = table_cover(onValues, dontCareValues, literals_count);
+            terms = primeImplicants; // add to heap pointers vector
+            covered = true;
+
+            if (deadline_set) {
+                coverResult.cover = primeImplicants;
+                coverResult.cost = primeImplicants.size();
+                coverResult.lower_bound = coverResult.cost;
+                coverResult.optimal = true;
+                searched = true;
+            }
+        } else if (engine == "zdd") {
+            if (perfCounters) {
+                perfCounters->startPhase("zdd");
+            }
+
+            double primes_count = 0;
+            primeImplicants = zdd_minimize(onValues, dontCareValues, literals_count, primes_count);
+            terms = primeImplicants; // add to heap pointers vector
+            covered = true;
+
+            if (debug) {
+                std::cerr << "zdd: " << primes_count << " primes" << std::endl;
+            }
+        } else if (engine == "consensus") {
+            for (std::vector<Cube>::iterator it = onCubes.begin();
+                 it < onCubes.end(); ++it)
+            {
+                terms.push_back(new Term(it->first, it->second, literals_count));
+            }
+
+            for (std::vector<unsigned int>::iterator it = onValues.begin();
+                 it < onValues.end(); ++it)
+            {
+                terms.push_back(new Term(*it, literals_count));
+            }
+
+            for (std::vector<Cube>::iterator it = dontCareCubes.begin();
+                 it < dontCareCubes.end(); ++it)
+            {
+                Term* term = new Term(it->first, it->second, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                Term* term = new Term(*it, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase("consensus");
+            }
+
+            consensus_terms(terms, primeTerms);
+        } else if (engine == "ternary" || engine == "shannon" || engine == "symmetric") {
+            Bitmap onSet(1u << literals_count);
+            Bitmap dontCareSet(1u << literals_count);
+            for (std::vector<unsigned int>::iterator it = onValues.begin();
+                 it < onValues.end(); ++it)
+            {
+                onSet.set(*it);
+            }
+
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                dontCareSet.set(*it);
+
+                // the cover phase still needs to know what not to cover
+                Term* term = new Term(*it, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase(engine);
+            }
+
+            if (engine == "ternary") {
+                ternary_terms(onSet, dontCareSet, literals_count, terms, primeTerms);
+            } else if (engine == "symmetric") {
+                SymmetricFunction symmetric(onSet, dontCareSet, literals_count);
+                if (debug) {
+                    std::cerr << "symmetric: blocks ";
+                    symmetric.print(std::cerr);
+                    std::cerr << (symmetric.isTractable() ? "" : ", too little symmetry") << std::endl;
+                }
+
+                // a function with little symmetry is left to the shannon engine
+                if (symmetric.isTractable()) {
+                    symmetric.generate(terms, primeTerms);
+                } else {
+                    shannon_terms(onSet, dontCareSet, literals_count, threads_count, terms, primeTerms);
+                }
+            } else {
+                shannon_terms(onSet, dontCareSet, literals_count, threads_count, terms, primeTerms);
+            }
+        } else if (engine == "heuristic") {
+            Bitmap onSet(1u << literals_count);
+            Bitmap dontCareSet(1u << literals_count);
+            for (std::vector<unsigned int>::iterator it = onValues.begin();
+                 it < onValues.end(); ++it)
+            {
+                onSet.set(*it);
+            }
+
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                dontCareSet.set(*it);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase("heuristic");
+            }
+
+            // the heuristic is what the budget falls back to, so it has none
+            budget.disable();
+            exact = false;
+
+            primeImplicants = expand_cover(onSet, dontCareSet, literals_count);
+            terms = primeImplicants; // add to heap pointers vector
+            covered = true;
+        } else if (engine == "pipelined") {
+            for (std::vector<unsigned int>::iterator it = onValues.begin();
+                 it < onValues.end(); ++it)
+            {
+                terms.push_back(new Term(*it, literals_count));
+            }
+
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                Term* term = new Term(*it, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase("pipeline");
+            }
+
+            // primes go into the chart while the combine levels still run
+            CoverChart chart(dontCareTerms);
+            pipelined_terms(terms, primeTerms, chart, threads_count);
+
+            if (perfCounters) {
+                perfCounters->startPhase("cover");
+            }
+
+            primeImplicants = chart_cover(chart);
+            if (deadline_set) {
+                Deadline deadline(settings.deadline_ms);
+                coverResult = settings.portfolio
+                              ? portfolio_chart_cover(chart, primeImplicants, deadline, threads_count)
+                              : search_chart_cover(chart, primeImplicants, deadline);
+                primeImplicants = coverResult.cover;
+                searched = true;
+            }
+
+            covered = true;
+        } else if (!settings.spill_directory.empty()) {
+            // only the Dont-Cares (for the cover) and the primes are Terms
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                Term* term = new Term(*it, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase("combine");
+            }
+
+            combine_external_terms(onValues, dontCareValues, literals_count, settings.spill_directory,
+                                   terms, primeTerms);
+        } else {
+            for (std::vector<unsigned int>::iterator it = onValues.begin();
+                 it < onValues.end(); ++it)
+            {
+                terms.push_back(new Term(*it, literals_count));
+            }
+
+            for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+                 it < dontCareValues.end(); ++it)
+            {
+                Term* term = new Term(*it, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            for (std::vector<Cube>::iterator it = onCubes.begin();
+                 it < onCubes.end(); ++it)
+            {
+                terms.push_back(new Term(it->first, it->second, literals_count));
+            }
+
+            for (std::vector<Cube>::iterator it = dontCareCubes.begin();
+                 it < dontCareCubes.end(); ++it)
+            {
+                Term* term = new Term(it->first, it->second, literals_count);
+                term->dontCare();
+                terms.push_back(term);
+                dontCareTerms.push_back(term);
+            }
+
+            if (perfCounters) {
+                perfCounters->startPhase("combine");
+            }
+
+            if (checkpoint) {
+                // --resume continues from the last phase the checkpoint holds
+                checkpoint->open(onValues, dontCareValues, literals_count);
+                if (checkpoint->getPhase() == Checkpoint::COVER) {
+                    checkpoint->restoreCover(primeImplicants, coverResult, searched, terms);
+                    covered = true;
+                } else if (checkpoint->getPhase() == Checkpoint::PRIMES ||
+                           checkpoint->getPhase() == Checkpoint::SEARCH)
+                {
+                    // a SEARCH checkpoint's cover seeds the search below
+                    checkpoint->restorePrimes(primeTerms, terms);
+                } else {
+                    combine_terms(terms, primeTerms, checkpoint);
+                    checkpoint->savePrimes(primeTerms);
+                }
+            } else if (seeded) {
+                combine_cube_terms(terms, primeTerms);
+            } else if (prune_dont_cares) {
+                combine_on_terms(terms, primeTerms);
+            } else {
+                combine_terms(terms, primeTerms);
+            }
+        }
+
+//        std::cout << "pre-minimize: f = " << terms_function(primeTerms) << std::endl;
+
+        // inside the budget's handler: the chart enumerates the cubes'
+        // minterms, which are charged then
+        if (exact && !covered) {
+            if (perfCounters) {
+                perfCounters->startPhase("cover");
+            }
+
+            if (deadline_set) {
+                // the deadline is for the search, not for reading or generating the primes
+                Deadline deadline(settings.deadline_ms);
+                coverResult = settings.portfolio
+                              ? portfolio_cover(primeTerms, dontCareTerms, deadline, threads_count, checkpoint)
+                              : search_cover(primeTerms, dontCareTerms, deadline, checkpoint);
+                primeImplicants = coverResult.cover;
+                searched = true;
+            } else if (search) {
+                Deadline searchDeadline(AUTO_SEARCH_MS);
+                coverResult = search_cover(primeTerms, dontCareTerms, searchDeadline, checkpoint);
+                primeImplicants = coverResult.cover;
+                searched = true;
+            } else {
+                primeImplicants = select_cover(primeTerms, dontCareTerms);
+            }
+
+            if (checkpoint) {
+                checkpoint->saveCover(primeImplicants, coverResult, searched);
+            }
+        }
+    } catch (std::bad_alloc& e) {
+        std::cerr << "qmc: " << e.what() << " (peak " << budget.getPeakBytes()
+                  << " bytes)" << std::endl;
+
+        for (Terms::iterator it = terms.begin(); 
+             it < terms.end(); ++it) 
+        {
+            delete (*it);
+        }
+
+        terms.clear();
+        dontCareTerms.clear();
+        primeTerms.clear();
+        primeImplicants.clear();
+        coverResult = CoverResult();
+        searched = false;
+
+        if (settings.budget_fallback != "heuristic") {
+            result.aborted = true;
+            return;
+        }
+
+        // the heuristic's bitmaps would not fit the budget either
+        if (literals_count > MintermReader::BITMAP_MAX_LITERALS) {
+            std::cerr << "qmc: the bounded memory heuristic supports up to "
+                      << MintermReader::BITMAP_MAX_LITERALS << " literals" << std::endl;
+            result.aborted = true;
+            return;
+        }
+
+        std::cerr << "qmc: falling back to the bounded memory heuristic, "
+                  << "the result is not guaranteed to be minimal" << std::endl;
+
+        budget.disable();
+        exact = false;
+
+        // the cube engines kept their input as cubes
+        expand_cubes(onCubes, onValues);
+        expand_cubes(dontCareCubes, dontCareValues);
+        onCubes.clear();
+        dontCareCubes.clear();
+
+        Bitmap onSet((size_t)1 << literals_count);
+        Bitmap dontCareSet((size_t)1 << literals_count);
+        for (std::vector<unsigned int>::iterator it = onValues.begin();
+             it < onValues.end(); ++it)
+        {
+            onSet.set(*it);
+        }
+
+        for (std::vector<unsigned int>::iterator it = dontCareValues.begin();
+             it < dontCareValues.end(); ++it)
+        {
+            dontCareSet.set(*it);
+        }
+
+        if (perfCounters) {
+            perfCounters->startPhase("heuristic");
+        }
+
+        primeImplicants = expand_cover(onSet, dontCareSet, literals_count);
+        terms = primeImplicants; // add to heap pointers vector
+    }
+}
+
+/**
+ * The minterms in neither set of function, over a bitmap in one pass.
+ */
+void complement_values(const Function& function, size_t literals_count,
+                       std::vector<unsigned int>& complement)
+{
+    Bitmap covered((size_t)1 << literals_count);
+    const std::vector<unsigned int>* values[] = { &function.onValues, &function.dontCareValues };
+    const std::vector<Cube>* cubes[] = { &function.onCubes, &function.dontCareCubes };
+    for (size_t i = 0; i < 2; ++i) {
+        for (std::vector<unsigned int>::const_iterator it = values[i]->begin();
+             it < values[i]->end(); ++it)
+        {
+            covered.set(*it);
+        }
+
+        for (std::vector<Cube>::const_iterator it = cubes[i]->begin();
+             it < cubes[i]->end(); ++it)
+        {
+            unsigned int offset = 0;
+            do {
+                covered.set(it->first | offset);
+                offset = (offset - it->second) & it->second;
+            } while (offset != 0);
+        }
+    }
+
+    const std::vector<uint64_t>& words = covered.getWords();
+    size_t minterms_count = (size_t)1 << literals_count;
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t free = ~words[w];
+        if (minterms_count - w * 64 < 64) {
+            free &= ((uint64_t)1 << (minterms_count - w * 64)) - 1;
+        }
+
+        for (; free != 0; free &= free - 1) {
+            complement.push_back(w * 64 + __builtin_ctzll(free));
+        }
+    }
+}
+
+/**
+ * minimize() on a thread of its own; rethrow() passes on what it threw.
+ */
+class MinimizeTask {
+    public:
+        MinimizeTask(const Settings& settings, Function& function, Minimization& result) :
+            _settings(settings),
+            _function(function),
+            _result(result),
+            _error()
+        {
+        }
+
+        void operator()() {
+            try {
+                minimize(_settings, _function, 0, _result);
+            } catch (...) {
+                _error = std::current_exception();
+            }
+        }
+
+        void rethrow() const {
+            if (_error) {
+                std::rethrow_exception(_error);
+            }
+        }
+
+    private:
+        const Settings& _settings;
+        Function& _function;
+        Minimization& _result;
+        std::exception_ptr _error;
+};
+
+/**
+ * --session: loads the function into a Minimizer, then reads edits
+ * ("add N", "remove N" or "dc N") from input and prints the cover after
+ * each one.
+ */
+int run_session(size_t literals_count,
+                const std::vector<unsigned int>& onValues,
+                const std::vector<unsigned int>& dontCareValues,
+                std::istream& input,
+                std::ostream& output)
+{
+    Minimizer minimizer(literals_count, onValues, dontCareValues);
+    output << "f = " << cubes_function(minimizer.getCover(), literals_count) << std::endl;
+
+    unsigned long long all = ((unsigned long long)1 << literals_count) - 1;
+    std::string command;
+    while (input >> command) {
+        unsigned long long minterm = 0;
+        if (!(input >> minterm) || minterm > all) {
+            std::cerr << "error: '" << command << "' needs a minterm below 2^"
+                      << literals_count << std::endl;
+            return 1;
+        }
+
+        if (command == "add") {
+            minimizer.addMinterm(minterm);
+        } else if (command == "remove") {
+            minimizer.removeMinterm(minterm);
+        } else if (command == "dc") {
+            minimizer.setDontCare(minterm);
+        } else {
+            std::cerr << "error: unknown edit '" << command << "'" << std::endl;
+            return 1;
+        }
+
+        output << "f = " << cubes_function(minimizer.getCover(), literals_count) << std::endl;
+    }
+
+    return 0;
+}
+
 int main(int argc, char** argv) {
     namespace po = boost::program_options;
 
-    int literals_count;
+    int literals_count = 0;
     bool debug;
+    bool perf;
+    size_t max_implicants;
+    std::string budget_fallback;
+    double deadline_ms;
+    std::string engine;
+    size_t threads_count;
+    bool prune_dont_cares;
+    bool best_form;
+    bool session;
+    bool full_support;
+    bool stats;
+    bool verify;
+    bool portfolio;
+    std::string emit;
+    std::string emit_name;
+    double checkpoint_interval;
+    bool resume;
 
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help", "produce help message")
-        ("sop", po::value< std::vector<int> >()->multitoken(), "SOP terms")
-        ("pos", po::value< std::vector<int> >()->multitoken(), "POS terms")
-        ("dont-care", po::value< std::vector<int> >()->multitoken(), "Dont-Care terms")
-        ("literals-count,l", po::value<int>(&literals_count)->required(), "Literals count")
+        ("sop", po::value< std::vector<std::string> >()->multitoken(), "SOP terms (N, A-B or A-B:STRIDE)")
+        ("pos", po::value< std::vector<std::string> >()->multitoken(), "POS terms (maxterms)")
+        ("dont-care", po::value< std::vector<std::string> >()->multitoken(), "Dont-Care terms")
+        ("off", po::value< std::vector<std::string> >()->multitoken(), "OFF terms, making every term neither ON nor OFF a Dont-Care")
+        ("input", po::value<std::string>(), "Read sop/pos/dc terms from a file ('-' for stdin)")
+        ("pla", po::value<std::string>(), "Read ON/Dont-Care cubes from a single output PLA file")
+        ("cubes", po::value< std::vector<std::string> >()->multitoken(), "ON cubes, e.g. 1-0-")
+        ("dc-cubes", po::value< std::vector<std::string> >()->multitoken(), "Dont-Care cubes")
+        ("expr", po::value< std::vector<std::string> >()->multitoken(), "ON-set as an expression, e.g. \"a'b + c(d + e')\"")
+        ("dc-expr", po::value< std::vector<std::string> >()->multitoken(), "Dont-Care set as an expression")
+        ("literals-count,l", po::value<int>(&literals_count), "Literals count")
         ("debug", po::value<bool>(&debug)->default_value(false), "Show debug information")
+        ("perf", po::bool_switch(&perf), "Report hardware performance counters per phase")
+        ("max-memory", po::value<std::string>(), "Memory budget for implicants (e.g. 512M, 2G)")
+        ("max-implicants", po::value<size_t>(&max_implicants)->default_value(0), "Maximum number of implicants (0 = unlimited)")
+        ("budget-fallback", po::value<std::string>(&budget_fallback)->default_value("abort"), "On budget exhaustion: abort | heuristic")
+        ("engine", po::value<std::string>(&engine)->default_value("auto"), "Prime generation engine: auto | tabular | zdd | consensus | pipelined | ternary | shannon | symmetric | heuristic")
+        ("stats", po::bool_switch(&stats), "Print the statistics --engine auto chooses from, and its choice")
+        ("best-form", po::bool_switch(&best_form), "Minimize the SOP and POS forms concurrently and print the cheaper one")
+        ("session", po::bool_switch(&session), "Read add/remove/dc edits from stdin and print the cover after each")
+        ("full-support", po::bool_switch(&full_support), "Keep the variables f does not depend on")
+        ("prune-dc", po::bool_switch(&prune_dont_cares), "Tabular engine: never build implicants made of Dont-Cares only")
+        ("verify", po::bool_switch(&verify), "Check the result against the input on every assignment")
+        ("emit", po::value<std::string>(&emit), "Print code for the result instead: c | table | verilog")
+        ("emit-name", po::value<std::string>(&emit_name)->default_value("f"), "Function / module name for --emit")
+        ("threads", po::value<size_t>(&threads_count)->default_value(std::thread::hardware_concurrency()), "Worker threads for the pipelined and shannon engines")
+        ("deadline", po::value<double>(&deadline_ms)->default_value(0), "Search for a better cover until MS milliseconds have passed (0 = greedy cover only)")
+        ("portfolio", po::bool_switch(&portfolio), "Search the cover with --threads strategies at once, sharing the best cost (with --deadline)")
+        ("checkpoint", po::value<std::string>(), "Tabular engine: save the minimization state to this directory")
+        ("checkpoint-interval", po::value<double>(&checkpoint_interval)->default_value(60), "Seconds between two --checkpoint saves of the combine phase")
+        ("resume", po::bool_switch(&resume), "Continue from the last checkpoint in the --checkpoint directory")
+        ("spill", po::value<std::string>(), "Tabular engine: keep the implicant levels in this directory, not in memory")
     ;
 
 //    po::positional_options_description p;
@@ -116,312 +1020,512 @@ int main(int argc, char** argv) {
     
     po::notify(vm);
 
-    Terms terms;
-    Terms dontCareTerms;
-    Terms primeTerms;
+    PerfCounters* perfCounters = 0;
+    if (perf) {
+        perfCounters = new PerfCounters();
+        perfCounters->startPhase("input");
+    }
 
-    if (vm.count("sop")) {
-        BOOST_FOREACH (int term_val, vm["sop"].as< std::vector<int>  >())
-        {
-            Term* term = new Term(term_val, literals_count);
-            terms.push_back(term);
+    std::vector<unsigned int> onValues;
+    std::vector<unsigned int> dontCareValues;
+    std::vector<Cube> onCubes;
+    std::vector<Cube> dontCareCubes;
+
+    if (vm.count("pla")) {
+        std::ifstream pla_file(vm["pla"].as<std::string>().c_str());
+        if (!pla_file) {
+            std::cerr << "error: cannot open '" << vm["pla"].as<std::string>() << "'" << std::endl;
+            return 1;
         }
-    }
-    
-    if (vm.count("pos")) {
-        BOOST_FOREACH (int term_val, vm["pos"].as< std::vector<int>  >())
-        {
-            // calculate the SOP term for the POS term - 2^(literals) - 1 - minterm
-            Term* term = new Term(pow(2, literals_count) - 1 - term_val, literals_count);
-            terms.push_back(term);
+
+        size_t pla_literals_count = 0;
+        try {
+            read_pla(pla_file, pla_literals_count, onCubes, dontCareCubes);
+        } catch (std::runtime_error& e) {
+            std::cerr << "error: " << e.what() << std::endl;
+            return 1;
+        }
+
+        if (vm.count("literals-count") && (size_t)literals_count != pla_literals_count) {
+            std::cerr << "error: --literals-count does not match the PLA's .i" << std::endl;
+            return 1;
         }
+
+        literals_count = pla_literals_count;
     }
-    
-    if (vm.count("dont-care")) {
-        BOOST_FOREACH (int term_val, vm["dont-care"].as< std::vector<int>  >())
+
+    const char* cube_options[] = { "cubes", "dc-cubes" };
+    std::vector<Cube>* cube_sets[] = { &onCubes, &dontCareCubes };
+    for (size_t i = 0; i < 2; ++i) {
+        if (!vm.count(cube_options[i])) {
+            continue;
+        }
+
+        // cubes starting with a dash read as options, so a token may also be
+        // a comma separated list: --cubes=-0-1,1--0
+        std::string list;
+        BOOST_FOREACH (const std::string& token, vm[cube_options[i]].as< std::vector<std::string> >())
         {
-            Term* term = new Term(term_val, literals_count);
-            term->dontCare();
-            terms.push_back(term);
-            dontCareTerms.push_back(term);
+            list.append(token).append(",");
         }
-    }
 
-    std::sort(terms.begin(), terms.end(), Term::PointerCompare());
+        std::istringstream tokens(list);
+        std::string text;
+        while (std::getline(tokens, text, ',')) {
+            if (text.empty()) {
+                continue;
+            }
 
-    std::queue<Term*> termsQueue;
-    for (Terms::iterator it = terms.begin(); 
-        it < terms.end(); ++it) 
-    {
-        termsQueue.push(*it);
-    }
+            Cube cube;
+            if (!parse_cube(text, cube)) {
+                std::cerr << "error: invalid cube '" << text << "'" << std::endl;
+                return 1;
+            }
 
-    termsQueue.push(0); // separating the algorithm steps
-    
-    Terms currentTerms;
-    Terms nextTerms;
-    while (!termsQueue.empty()) {
-        // 1. go over the queue, while adding to current terms
-        //    a. if 0 or different number of ones, stop adding.
-        //    b. if 0, add unselected to primes.
-        //    c. if number of ones is bigger by one, fetch until 0 or different number of ones.
-        //    d. compare and push to queue.
-        //    e. clear next and current.
-
-        Term* first;
-        Term* front;
-        bool match_terms = true;
-        bool find_next_terms = true;
-        if (currentTerms.empty()) {
-            // get the first term in the queue
-            first = termsQueue.front();
-            
-            // get all the terms in the queue with the same amount of
-            // ones in the binary representation
-            while (!termsQueue.empty()) {
-                front = termsQueue.front();
-                
-                if (front == 0 || first == 0) {
-                    termsQueue.pop();
-                    match_terms = false;
-                    find_next_terms = false;
-                    break;
-                }
-                
-                if ((front->oneCount() - first->oneCount()) > 1) {
-                    match_terms = false;
-                    find_next_terms = false;
-                    break;
-                }
+            // without -l the first cube tells the literals count
+            if (literals_count == 0) {
+                literals_count = text.length();
+            }
 
-                if (front->oneCount() != first->oneCount()) {
-                    // difference is exactly 1.
-                    // we should start adding next terms.
-                    break;
-                }
-                
-                currentTerms.push_back(front);
-                termsQueue.pop();
+            if (text.length() != (size_t)literals_count) {
+                std::cerr << "error: cube '" << text << "' does not have "
+                          << literals_count << " literals" << std::endl;
+                return 1;
             }
+
+            cube_sets[i]->push_back(cube);
         }
+    }
 
-        // by now we have some currentTerms, and are ready to insert
-        // to nextTerms.
+    // expressions become cubes without going through minterms
+    const char* expression_options[] = { "expr", "dc-expr" };
+    std::string expressions[2];
+    for (size_t i = 0; i < 2; ++i) {
+        if (!vm.count(expression_options[i])) {
+            continue;
+        }
 
-        nextTerms.clear();
-        
-        if (find_next_terms && currentTerms.size() > 0) {
-            // get the first term in the queue
-            first = termsQueue.front();
+        BOOST_FOREACH (const std::string& token, vm[expression_options[i]].as< std::vector<std::string> >())
+        {
+            expressions[i].append(token).append(" ");
+        }
 
-            // get all the terms in the queue with the same amount of
-            // ones in the binary representation
-            while (!termsQueue.empty()) {
-                front = termsQueue.front();
+        // without -l the highest letter tells the literals count
+        if (!vm.count("literals-count") && onCubes.empty() && dontCareCubes.empty()) {
+            literals_count = std::max(literals_count, (int)expression_literals_count(expressions[i]));
+        }
+    }
 
-                if (front == 0 || first == 0) {
-                    termsQueue.pop();
-                    termsQueue.push(0);
-                    break;
-                }
+    for (size_t i = 0; i < 2; ++i) {
+        // a literals count out of range is reported below
+        if (!vm.count(expression_options[i]) || literals_count <= 0 || literals_count > 32) {
+            continue;
+        }
 
-                if (front->oneCount() != first->oneCount()) {
-                    // we should start processing the current terms sets.
-                    break;
-                }
+        try {
+            parse_expression(expressions[i], literals_count, *cube_sets[i]);
+        } catch (std::runtime_error& e) {
+            std::cerr << "error: --" << expression_options[i] << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (literals_count <= 0 || literals_count > 32) {
+        std::cerr << "error: --literals-count between 1 and 32 is required" << std::endl;
+        return 1;
+    }
 
-                nextTerms.push_back(front);
-                termsQueue.pop();
+    MintermReader mintermReader(literals_count);
+    try {
+        const char* options[] = { "sop", "pos", "dont-care", "off" };
+        MintermReader::Set sets[] = { MintermReader::SOP, MintermReader::POS, MintermReader::DONT_CARE,
+                                      MintermReader::OFF };
+        for (size_t i = 0; i < 4; ++i) {
+            if (!vm.count(options[i])) {
+                continue;
             }
-        }
-        
-        if (match_terms && currentTerms.size() > 0 && nextTerms.size() > 0) {
-            // now we have two lists of terms - current and next, which
-            // are adjacent groups in a Quine-McCluskey table.
-            // we should compare each current term and next term and
-            // push new terms to the end of the queue.
-            for (Terms::iterator c_it = currentTerms.begin();
-                 c_it < currentTerms.end(); ++c_it)
+
+            BOOST_FOREACH (const std::string& token, vm[options[i]].as< std::vector<std::string> >())
             {
-                Term* current_term = *c_it;
-                for (Terms::iterator n_it = nextTerms.begin();
-                     n_it < nextTerms.end(); ++n_it)
-                {
-                    Term* next_term = *n_it;
-                    int separating_bit = current_term->separatingBit(*next_term);
-                    if (separating_bit > -1) {
-                        current_term->select();
-                        next_term->select();
-
-                        Term* new_term = new Term(*current_term, 
-                                                  *next_term, 
-                                                  separating_bit+1);
-                        termsQueue.push(new_term);
-                        terms.push_back(new_term); // add to heap pointers vector
-                    }
-                }
+                mintermReader.addToken(sets[i], token);
             }
+        }
+
+        if (vm.count("input")) {
+            std::string input_name = vm["input"].as<std::string>();
+            if (input_name == "-") {
+                mintermReader.read(std::cin);
+            } else {
+                std::ifstream input_file(input_name.c_str());
+                if (!input_file) {
+                    std::cerr << "error: cannot open '" << input_name << "'" << std::endl;
+                    return 1;
+                }
 
+                mintermReader.read(input_file);
+            }
         }
+    } catch (std::runtime_error& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
 
-        // if we got here, we should try to add unselected terms
-        // from both current terms and next terms and then clear both lists.
+    mintermReader.getValues(MintermReader::SOP, onValues);
+    mintermReader.getValues(MintermReader::DONT_CARE, dontCareValues);
+
+    // --pos terms are maxterms: the OFF-set, minimized as the complement
+    std::vector<unsigned int> offValues;
+    mintermReader.getValues(MintermReader::POS, offValues);
+    bool pos_input = !offValues.empty();
+    if (pos_input && (!onValues.empty() || !onCubes.empty())) {
+        std::cerr << "error: give the function either as --sop or as --pos terms" << std::endl;
+        return 1;
+    }
 
-        for (Terms::iterator it = currentTerms.begin();
-             it < currentTerms.end(); ++it)
+    // --off terms leave the Dont-Cares implicit
+    std::vector<unsigned int> offSetValues;
+    mintermReader.getValues(MintermReader::OFF, offSetValues);
+    bool off_input = vm.count("off") || !offSetValues.empty();
+    if (off_input) {
+        if (pos_input || !dontCareValues.empty() || !dontCareCubes.empty() || best_form || session ||
+            engine != "auto" || prune_dont_cares || vm.count("checkpoint") || vm.count("spill"))
         {
-            if (!(*it)->isSelected()) {
-                // make sure that we don't add terms that are made of
-                // only dont care terms.
-                if ((*it)->isDontCare()) {
-                    continue;
-                }
+            std::cerr << "error: --off takes --sop terms or ON cubes and generates the primes itself "
+                      << "(no Dont-Care terms, --pos, --best-form, --session or engine options)" << std::endl;
+            return 1;
+        }
 
-                // make sure we don't have that term in the list already
-                // (that can happen because 0,8-1,9 are equal to 0,1-8,9, for example)
-                bool is_duplicate = false;
+        expand_cubes(onCubes, onValues);
+        onCubes.clear();
+        std::sort(onValues.begin(), onValues.end());
+        onValues.erase(std::unique(onValues.begin(), onValues.end()), onValues.end());
 
-                for (Terms::iterator pt_it = primeTerms.begin(); 
-                    pt_it < primeTerms.end(); ++pt_it) 
-                {
-                    if ((*pt_it)->getExpression() == (*it)->getExpression()) {
-                        is_duplicate = true;
-                        break;
-                    }
-                }
+        std::vector<unsigned int> both;
+        std::set_intersection(onValues.begin(), onValues.end(), offSetValues.begin(), offSetValues.end(),
+                              std::back_inserter(both));
+        if (!both.empty()) {
+            std::cerr << "error: minterm " << both.front() << " is both ON and OFF" << std::endl;
+            return 1;
+        }
+    }
 
-                if (!is_duplicate) {
-                    primeTerms.push_back(*it);
-                }
-            }
+    if ((pos_input || best_form) && (size_t)literals_count > MintermReader::BITMAP_MAX_LITERALS) {
+        std::cerr << "error: --pos and --best-form support up to "
+                  << MintermReader::BITMAP_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (session) {
+        if (pos_input || (vm.count("input") && vm["input"].as<std::string>() == "-")) {
+            std::cerr << "error: --session reads its edits from stdin and takes --sop terms" << std::endl;
+            return 1;
         }
 
-        currentTerms = nextTerms;
+        expand_cubes(onCubes, onValues);
+        expand_cubes(dontCareCubes, dontCareValues);
+        delete perfCounters;
+        return run_session(literals_count, onValues, dontCareValues, std::cin, std::cout);
     }
-    
-//    std::cout << "pre-minimize: f = " << terms_function(primeTerms) << std::endl;
 
-    Terms primeImplicants;
-    ImplicantsMap implicantsMap;
-    for (Terms::iterator it = primeTerms.begin(); 
-        it < primeTerms.end(); ++it) 
-    {
-        Term* term = *it;
-        term->primeImplicantCandidate();
-        std::vector<size_t> minterms = term->getMinterms();
-        for (std::vector<size_t>::iterator mt_it = minterms.begin();
-             mt_it < minterms.end(); ++mt_it)
-        {
-            implicantsMap[*mt_it].push_back(term);
+    MemoryBudget& budget = MemoryBudget::instance();
+    try {
+        if (vm.count("max-memory")) {
+            budget.setMaxBytes(MemoryBudget::parseBytes(vm["max-memory"].as<std::string>()));
         }
+    } catch (std::invalid_argument& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    budget.setMaxImplicants(max_implicants);
+
+    if (verify && literals_count > 30) {
+        std::cerr << "error: --verify supports up to 30 literals" << std::endl;
+        return 1;
+    }
+
+    if (!emit.empty() && emit != "c" && emit != "table" && emit != "verilog") {
+        std::cerr << "error: unknown --emit '" << emit << "'" << std::endl;
+        return 1;
     }
 
-    // remove dontcare minterms from implicantsMap, as we don't need to
-    // actually cover them.
-    for (Terms::iterator it = dontCareTerms.begin();
-         it < dontCareTerms.end(); ++it)
+    if (emit == "table" && (size_t)literals_count > EMIT_TABLE_MAX_LITERALS) {
+        std::cerr << "error: --emit table supports up to "
+                  << EMIT_TABLE_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (budget_fallback != "abort" && budget_fallback != "heuristic") {
+        std::cerr << "error: unknown --budget-fallback '" << budget_fallback << "'" << std::endl;
+        return 1;
+    }
+
+    if (engine != "auto" && engine != "tabular" && engine != "zdd" && engine != "consensus" &&
+        engine != "pipelined" && engine != "ternary" && engine != "shannon" && engine != "symmetric" &&
+        engine != "heuristic")
     {
-        size_t minterm = (*it)->getDecimal();
-        for (Terms::iterator t_it = implicantsMap[minterm].begin();
-             t_it < implicantsMap[minterm].end(); ++t_it)
-        {
-            (*t_it)->coverMinterm(minterm);
+        std::cerr << "error: unknown --engine '" << engine << "'" << std::endl;
+        return 1;
+    }
+
+    if (engine == "ternary" && (size_t)literals_count > TERNARY_MAX_LITERALS) {
+        std::cerr << "error: the ternary engine supports up to "
+                  << TERNARY_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (engine == "shannon" && (size_t)literals_count > SHANNON_MAX_LITERALS) {
+        std::cerr << "error: the shannon engine supports up to "
+                  << SHANNON_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (engine == "symmetric" && (size_t)literals_count > MintermReader::BITMAP_MAX_LITERALS) {
+        std::cerr << "error: the symmetric engine supports up to "
+                  << MintermReader::BITMAP_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (engine == "heuristic" && (size_t)literals_count > MintermReader::BITMAP_MAX_LITERALS) {
+        std::cerr << "error: the heuristic engine supports up to "
+                  << MintermReader::BITMAP_MAX_LITERALS << " literals" << std::endl;
+        return 1;
+    }
+
+    if (portfolio && deadline_ms <= 0) {
+        std::cerr << "error: --portfolio runs the --deadline search, which needs a deadline" << std::endl;
+        return 1;
+    }
+
+    if ((engine == "zdd" || engine == "heuristic") && deadline_ms > 0) {
+        std::cerr << "error: --deadline searches the prime chart, which the "
+                  << engine << " engine does not build" << std::endl;
+        return 1;
+    }
+
+    if (resume && !vm.count("checkpoint")) {
+        std::cerr << "error: --resume needs the --checkpoint directory" << std::endl;
+        return 1;
+    }
+
+    if (vm.count("spill")) {
+        if (engine == "auto") {
+            engine = "tabular";
         }
 
-        implicantsMap[minterm].clear();
+        if (engine != "tabular" || prune_dont_cares || vm.count("checkpoint")) {
+            std::cerr << "error: --spill supports the tabular engine, "
+                      << "without --prune-dc and --checkpoint" << std::endl;
+            return 1;
+        }
     }
 
+    Checkpoint* checkpoint = 0;
+    if (vm.count("checkpoint")) {
+        // the checkpoint holds the tabular engine's levels
+        if (engine == "auto") {
+            engine = "tabular";
+        }
 
-    for (ImplicantsMap::iterator main_it = implicantsMap.begin();
-         main_it != implicantsMap.end(); ++main_it)
-    {
-        // find minterms that are only covered by one implicant, and remove any
-        // term from the map that cover the minterms that implicant does.
-        bool found_prime_implicant = false;
-        for (ImplicantsMap::iterator it = implicantsMap.begin();
-             it != implicantsMap.end(); ++it)
-        {
-            if ((*it).second.size() == 1) {
-                Term* term = (*it).second.at(0);
-                
-                // we found a new prime implicant!
-//                std::cout << "New (natural) prime implicant for term " << (*it).first << "! " << term->getExpression() <<
-//                        " (" << term->getDecimals() << ")" << std::endl;
-//                std::cout << (*it).second << std::endl;
-
-                term->primeImplicant();
-                found_prime_implicant = true;
-
-                primeImplicants.push_back(term);
-                std::vector<size_t> minterms = term->getMinterms();
-                for (std::vector<size_t>::iterator mt_it = minterms.begin();
-                     mt_it < minterms.end(); ++mt_it)
-                {
-                    for (Terms::iterator t_it = implicantsMap[*mt_it].begin();
-                         t_it < implicantsMap[*mt_it].end(); ++t_it)
-                    {
-                        (*t_it)->coverMinterm(*mt_it);
-                    }
+        if (engine != "tabular" || prune_dont_cares || best_form) {
+            std::cerr << "error: --checkpoint supports the tabular engine, "
+                      << "without --prune-dc and --best-form" << std::endl;
+            return 1;
+        }
 
-                    implicantsMap[*mt_it].clear();
-                }
-            }
+        try {
+            checkpoint = new Checkpoint(vm["checkpoint"].as<std::string>(), checkpoint_interval * 1000, resume);
+        } catch (std::runtime_error& e) {
+            std::cerr << "error: " << e.what() << std::endl;
+            return 1;
         }
+    }
 
-        if (!found_prime_implicant) {
-            // choose an arbitrary implicant to be a prime implicant
-            // -- we are choosing the first term we can find that appears the most
-            std::sort(primeTerms.begin(), 
-                      primeTerms.end(), 
-                      Term::PrimeImplicantCandidatesCompare());
+    Settings settings;
+    settings.engine = engine;
+    settings.literals_count = literals_count;
+    settings.prune_dont_cares = prune_dont_cares;
+    settings.threads_count = threads_count;
+    settings.debug = debug;
+    settings.reduce_support = !full_support;
+    settings.stats = stats;
+    settings.budget_fallback = budget_fallback;
+    settings.spill_directory = vm.count("spill") ? vm["spill"].as<std::string>() : "";
+    settings.off_set = off_input;
+    settings.portfolio = portfolio;
+    settings.deadline_ms = deadline_ms;
 
-            // find the first non-prime implicant term
-            Term* term = 0;
-            for (Terms::iterator pt_it = primeTerms.begin();
-                 pt_it < primeTerms.end(); ++pt_it)
-            {
-                if (!(*pt_it)->isPrimeImplicant() 
-                    && (*pt_it)->getRemainingMinterms().size() > 0) 
-                {
-                    term = *pt_it;
-                    break;
-                }
+    // the SOP form minimizes the ON-set, the POS form the OFF-set (whose
+    // cover, complemented, is the product of sums); the set not given is
+    // the complement of the other one and the Dont-Cares
+    Function sop;
+    Function pos;
+    Function& given = pos_input ? pos : sop;
+    given.onValues = pos_input ? offValues : onValues;
+    given.onCubes = onCubes;
+    given.dontCareValues = dontCareValues;
+    given.dontCareCubes = dontCareCubes;
+    given.offValues = offSetValues;
+
+    bool run_sop = !pos_input || best_form;
+    bool run_pos = pos_input || best_form;
+    if (run_sop && run_pos) {
+        Function& other = pos_input ? sop : pos;
+        other.dontCareValues = dontCareValues;
+        other.dontCareCubes = dontCareCubes;
+        complement_values(given, literals_count, other.onValues);
+    }
+
+    Minimization sopResult;
+    Minimization posResult;
+    // a checkpoint of another function, or a spill directory that cannot
+    // be written, stops the run
+    try {
+        if (run_sop && run_pos) {
+            // both forms at once, the POS one on a second thread
+            if (perfCounters) {
+                perfCounters->startPhase("best-form");
             }
-            
-            if (term == 0) {
-                // we don't have any more prime terms! we are done.
-                break;
+
+            MinimizeTask posTask(settings, pos, posResult);
+            std::thread posThread(std::ref(posTask));
+            try {
+                minimize(settings, sop, 0, sopResult);
+            } catch (...) {
+                posThread.join();
+                throw;
             }
 
-            // we found a new prime implicant!
-//            std::cout << "New prime implicant! " << term->getExpression() <<
-//                    " (" << term->getDecimals() << ")" << std::endl;
-            term->primeImplicant();
-            primeImplicants.push_back(term);
+            posThread.join();
+            posTask.rethrow();
+        } else if (run_sop) {
+            minimize(settings, sop, perfCounters, sopResult, checkpoint);
+        } else {
+            minimize(settings, pos, perfCounters, posResult, checkpoint);
+        }
+    } catch (std::runtime_error& e) {
+        std::cerr << "error: " << e.what() << std::endl;
+        delete_terms(sopResult.terms);
+        delete_terms(posResult.terms);
+        delete perfCounters;
+        delete checkpoint;
+        return 1;
+    }
+
+    delete checkpoint;
+    if (sopResult.aborted || posResult.aborted) {
+        delete_terms(sopResult.terms);
+        delete_terms(posResult.terms);
+        delete perfCounters;
+        return 2;
+    }
+
+    // the cheaper form: fewer products (sums), then fewer literals
+    bool product_of_sums = !run_sop;
+    if (run_sop && run_pos) {
+        size_t sop_products = sopResult.primeImplicants.size();
+        size_t pos_sums = posResult.primeImplicants.size();
+        product_of_sums = pos_sums < sop_products ||
+                          (pos_sums == sop_products &&
+                           cover_literals(posResult.primeImplicants) < cover_literals(sopResult.primeImplicants));
+    }
+
+    Minimization& chosen = product_of_sums ? posResult : sopResult;
+    Function& chosenFunction = product_of_sums ? pos : sop;
+    Terms& primeImplicants = chosen.primeImplicants;
+
+    int status = 0;
+    if (verify) {
+        if (perfCounters) {
+            perfCounters->startPhase("verify");
+        }
+
+        Bitmap onSet(1u << literals_count);
+        Bitmap dontCareSet(1u << literals_count);
+        std::vector<unsigned int> onMinterms(chosenFunction.onValues);
+        std::vector<unsigned int> dontCareMinterms(chosenFunction.dontCareValues);
+        expand_cubes(chosenFunction.onCubes, onMinterms);
+        expand_cubes(chosenFunction.dontCareCubes, dontCareMinterms);
+        for (std::vector<unsigned int>::iterator it = onMinterms.begin();
+             it < onMinterms.end(); ++it)
+        {
+            onSet.set(*it);
+        }
 
-            std::vector<size_t> minterms = term->getMinterms();
-            for (std::vector<size_t>::iterator mt_it = minterms.begin();
-                 mt_it < minterms.end(); ++mt_it)
+        for (std::vector<unsigned int>::iterator it = dontCareMinterms.begin();
+             it < dontCareMinterms.end(); ++it)
+        {
+            dontCareSet.set(*it);
+        }
+
+        // with --off, whatever is neither ON nor OFF
+        if (off_input) {
+            for (size_t minterm = 0; minterm < dontCareSet.size(); ++minterm) {
+                dontCareSet.set(minterm);
+            }
+
+            for (std::vector<unsigned int>::iterator it = onMinterms.begin();
+                 it < onMinterms.end(); ++it)
             {
-                for (Terms::iterator t_it = implicantsMap[*mt_it].begin();
-                     t_it < implicantsMap[*mt_it].end(); ++t_it)
-                {
-                    (*t_it)->coverMinterm(*mt_it);
-                }
+                dontCareSet.reset(*it);
+            }
 
-                implicantsMap[*mt_it].clear();
+            for (std::vector<unsigned int>::iterator it = offSetValues.begin();
+                 it < offSetValues.end(); ++it)
+            {
+                dontCareSet.reset(*it);
             }
         }
+
+        unsigned int counterexample = 0;
+        CoverEvaluator evaluator(terms_cubes(primeImplicants), literals_count);
+        if (evaluator.verify(onSet, dontCareSet, counterexample)) {
+            std::cerr << "verify: ok" << std::endl;
+        } else {
+            std::cerr << "verify: mismatch on minterm " << counterexample
+                      << " (f = " << (evaluator.evaluate(counterexample) != product_of_sums)
+                      << ", expected " << (onSet.test(counterexample) != product_of_sums) << ")" << std::endl;
+            status = 3;
+        }
     }
 
-    std::cout << "f = " << terms_function(primeImplicants, debug) << std::endl;
+    if (perfCounters) {
+        perfCounters->stopPhase();
+    }
+
+    std::string function = "f = " + (product_of_sums ? terms_pos_function(primeImplicants, debug)
+                                                      : terms_function(primeImplicants, debug));
+    if (!chosen.exact) {
+        function.append(" (non-exact)");
+    }
+
+    if (emit == "c") {
+        emit_c(std::cout, terms_cubes(primeImplicants), literals_count, emit_name, function, product_of_sums);
+    } else if (emit == "table") {
+        emit_table(std::cout, terms_cubes(primeImplicants), literals_count, emit_name, function, product_of_sums);
+    } else if (emit == "verilog") {
+        emit_verilog(std::cout, terms_cubes(primeImplicants), literals_count, emit_name, function, product_of_sums);
+    } else {
+        std::cout << function << std::endl;
+    }
+
+    // an exact cover --engine auto chose does not add to the output
+    if (chosen.searched && deadline_ms > 0 && emit.empty()) {
+        std::cout << "cost = " << chosen.coverResult.cost
+                  << ", lower bound = " << chosen.coverResult.lower_bound
+                  << (chosen.coverResult.optimal ? " (optimal)" : " (deadline reached)")
+                  << std::endl;
+    }
+
+    if (perfCounters) {
+        perfCounters->report(std::cerr, sopResult.terms.size() + posResult.terms.size());
+        delete perfCounters;
+    }
     
     // clean everything!
  
-    for (Terms::iterator it = terms.begin(); 
-         it < terms.end(); ++it) 
-    {
-        delete (*it);
-        *it = 0;
-    }
+    delete_terms(sopResult.terms);
+    delete_terms(posResult.terms);
+
+    return status;
 }
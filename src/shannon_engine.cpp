@@ -0,0 +1,312 @@
+#include "../include/shannon_engine.h"
+#include "../include/cube_input.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+
+namespace {
+    typedef std::vector<Cube> Cubes;
+
+    enum Constant {
+        ZERO,
+        ONE,
+        MIXED
+    };
+
+    bool larger(const Cube& first, const Cube& second) {
+        return __builtin_popcount(first.second) > __builtin_popcount(second.second);
+    }
+
+    uint64_t cube_key(const Cube& cube) {
+        return ((uint64_t)cube.second << 32) | cube.first;
+    }
+
+    /**
+     * Drops the duplicates and the cubes contained in another one. Cubes go
+     * largest first, so a cube only needs one lookup per kept dash mask
+     * containing its own, and those masks are listed once per dash mask.
+     */
+    void absorb(Cubes& cubes) {
+        std::tr1::unordered_set<uint64_t> keys;
+        Cubes unique;
+        for (Cubes::iterator it = cubes.begin(); it < cubes.end(); ++it) {
+            if (keys.insert(cube_key(*it)).second) {
+                unique.push_back(*it);
+            }
+        }
+
+        std::stable_sort(unique.begin(), unique.end(), larger);
+
+        typedef std::tr1::unordered_map<unsigned int, std::vector<unsigned int> > Supersets;
+        Supersets supersets;
+        std::tr1::unordered_set<unsigned int> kept_masks;
+        std::vector<unsigned int> masks;
+        keys.clear();
+        cubes.clear();
+        for (Cubes::iterator it = unique.begin(); it < unique.end(); ++it) {
+            Supersets::iterator found = supersets.find(it->second);
+            if (found == supersets.end()) {
+                found = supersets.insert(std::make_pair(it->second, std::vector<unsigned int>())).first;
+                for (std::vector<unsigned int>::iterator m_it = masks.begin(); m_it < masks.end(); ++m_it) {
+                    if ((*m_it & it->second) == it->second) {
+                        found->second.push_back(*m_it);
+                    }
+                }
+            }
+
+            bool contained = false;
+            for (std::vector<unsigned int>::iterator m_it = found->second.begin();
+                 m_it < found->second.end() && !contained; ++m_it)
+            {
+                contained = keys.count(cube_key(Cube(it->first & ~*m_it, *m_it))) > 0;
+            }
+
+            if (contained) {
+                continue;
+            }
+
+            if (kept_masks.insert(it->second).second) {
+                masks.push_back(it->second);
+            }
+
+            keys.insert(cube_key(*it));
+            cubes.push_back(*it);
+        }
+    }
+
+    /**
+     * The primes of f from those of its cofactors on variable (bit) top:
+     * both cofactors' cubes are over the bits below it.
+     */
+    void merge(const Cubes& low, const Cubes& high, unsigned int top, Cubes& primes) {
+        // a prime of both cofactors is a prime of f0f1 containing every
+        // intersection it takes part in, so only the others are intersected
+        std::tr1::unordered_set<uint64_t> low_keys;
+        for (Cubes::const_iterator it = low.begin(); it < low.end(); ++it) {
+            low_keys.insert(cube_key(*it));
+        }
+
+        Cubes both;
+        Cubes high_only;
+        std::tr1::unordered_set<uint64_t> common;
+        for (Cubes::const_iterator it = high.begin(); it < high.end(); ++it) {
+            if (low_keys.count(cube_key(*it))) {
+                common.insert(cube_key(*it));
+                both.push_back(*it);
+            } else {
+                high_only.push_back(*it);
+            }
+        }
+
+        Cubes low_only;
+        for (Cubes::const_iterator it = low.begin(); it < low.end(); ++it) {
+            if (!common.count(cube_key(*it))) {
+                low_only.push_back(*it);
+            }
+        }
+
+        // P(f0f1): the pairwise intersections, minus the contained ones
+        for (Cubes::iterator l_it = low_only.begin(); l_it < low_only.end(); ++l_it) {
+            for (Cubes::iterator h_it = high_only.begin(); h_it < high_only.end(); ++h_it) {
+                if (((l_it->first ^ h_it->first) & ~(l_it->second | h_it->second)) != 0) {
+                    continue;
+                }
+
+                unsigned int dash_mask = l_it->second & h_it->second;
+                both.push_back(Cube((l_it->first | h_it->first) & ~dash_mask, dash_mask));
+            }
+        }
+
+        absorb(both);
+
+        // a prime of a cofactor is in P(f0f1) or is not contained in any of it
+        std::tr1::unordered_set<uint64_t> shared;
+        for (Cubes::iterator it = both.begin(); it < both.end(); ++it) {
+            shared.insert(cube_key(*it));
+            primes.push_back(Cube(it->first, it->second | top));
+        }
+
+        for (Cubes::iterator it = low_only.begin(); it < low_only.end(); ++it) {
+            if (!shared.count(cube_key(*it))) {
+                primes.push_back(*it);
+            }
+        }
+
+        for (Cubes::iterator it = high_only.begin(); it < high_only.end(); ++it) {
+            if (!shared.count(cube_key(*it))) {
+                primes.push_back(Cube(it->first | top, it->second));
+            }
+        }
+    }
+
+    class ShannonEngine {
+        public:
+            ShannonEngine(const Bitmap& care_set, size_t literals_count) :
+                _care(care_set.getWords()),
+                _literals_count(literals_count),
+                _cofactors(),
+                _merged(),
+                _bits(0),
+                _next(0),
+                _failed(false),
+                _mutex(),
+                _error()
+            {
+            }
+
+            void run(size_t threads_count, Cubes& primes) {
+                // enough cofactors for every thread to get a few
+                size_t depth = 0;
+                while (threads_count > 1 && ((size_t)1 << depth) < threads_count * 4 &&
+                       depth < _literals_count)
+                {
+                    depth++;
+                }
+
+                _bits = _literals_count - depth;
+                _cofactors.resize((size_t)1 << depth);
+                parallel(threads_count, &ShannonEngine::leafTask);
+
+                for (; depth > 0; --depth) {
+                    _bits++;
+                    _merged.assign(_cofactors.size() / 2, Cubes());
+                    parallel(threads_count, &ShannonEngine::mergeTask);
+                    _cofactors.swap(_merged);
+                }
+
+                primes.swap(_cofactors.front());
+            }
+
+        private:
+            ShannonEngine(const ShannonEngine&);
+
+            ShannonEngine& operator=(const ShannonEngine&);
+
+            void parallel(size_t threads_count, void (ShannonEngine::*task)(size_t)) {
+                size_t tasks_count = (task == &ShannonEngine::leafTask) ? _cofactors.size() : _merged.size();
+                _next = 0;
+
+                std::vector<std::thread> workers;
+                for (size_t i = 1; i < std::min(threads_count, tasks_count); ++i) {
+                    workers.push_back(std::thread(&ShannonEngine::work, this, task, tasks_count));
+                }
+
+                work(task, tasks_count);
+                for (std::vector<std::thread>::iterator it = workers.begin();
+                     it < workers.end(); ++it)
+                {
+                    it->join();
+                }
+
+                if (_error) {
+                    std::rethrow_exception(_error);
+                }
+            }
+
+            void work(void (ShannonEngine::*task)(size_t), size_t tasks_count) {
+                try {
+                    for (size_t i = _next++; i < tasks_count && !_failed; i = _next++) {
+                        (this->*task)(i);
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_error) {
+                        _error = std::current_exception();
+                    }
+
+                    _failed = true;
+                }
+            }
+
+            void leafTask(size_t i) {
+                primes(i << _bits, _bits, _cofactors[i]);
+            }
+
+            void mergeTask(size_t i) {
+                merge(_cofactors[2 * i], _cofactors[2 * i + 1], 1u << (_bits - 1), _merged[i]);
+                Cubes().swap(_cofactors[2 * i]);
+                Cubes().swap(_cofactors[2 * i + 1]);
+            }
+
+            // the cofactor over minterms offset .. offset + 2^bits - 1
+            Constant constant(size_t offset, size_t bits) const {
+                if (bits < 6) {
+                    uint64_t all = ((uint64_t)1 << (1u << bits)) - 1;
+                    uint64_t values = (_care[offset >> 6] >> (offset & 63)) & all;
+                    return values == 0 ? ZERO : (values == all ? ONE : MIXED);
+                }
+
+                bool any = false;
+                bool every = true;
+                size_t words_count = (size_t)1 << (bits - 6);
+                for (size_t w = offset >> 6; w < (offset >> 6) + words_count && (every || !any); ++w) {
+                    any |= _care[w] != 0;
+                    every &= _care[w] == ~(uint64_t)0;
+                }
+
+                return !any ? ZERO : (every ? ONE : MIXED);
+            }
+
+            void primes(size_t offset, size_t bits, Cubes& result) const {
+                switch (constant(offset, bits)) {
+                    case ZERO:
+                        return;
+                    case ONE:
+                        result.push_back(Cube(0, (1u << bits) - 1));
+                        return;
+                    default:
+                        break;
+                }
+
+                Cubes low;
+                Cubes high;
+                primes(offset, bits - 1, low);
+                primes(offset + ((size_t)1 << (bits - 1)), bits - 1, high);
+                merge(low, high, 1u << (bits - 1), result);
+            }
+
+            const std::vector<uint64_t>& _care;
+            size_t _literals_count;
+            std::vector<Cubes> _cofactors;
+            std::vector<Cubes> _merged;
+            size_t _bits;
+            std::atomic<size_t> _next;
+            std::atomic<bool> _failed; // the workers stop; _error is read once they are joined
+            std::mutex _mutex;
+            std::exception_ptr _error;
+    };
+}
+
+void shannon_terms(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count,
+                   size_t threads_count, Terms& terms, Terms& primeTerms)
+{
+    Bitmap care_set(on_set.size());
+    std::vector<uint64_t>& care = care_set.getWords();
+    for (size_t w = 0; w < care.size(); ++w) {
+        care[w] = on_set.getWords()[w] | dont_care_set.getWords()[w];
+    }
+
+    Cubes primes;
+    ShannonEngine engine(care_set, literals_count);
+    engine.run(threads_count, primes);
+
+    for (Cubes::iterator it = primes.begin(); it < primes.end(); ++it) {
+        // keep the primes touching the ON-set
+        unsigned int offset = 0;
+        do {
+            if (on_set.test(it->first | offset)) {
+                Term* term = new Term(it->first, it->second, literals_count);
+                terms.push_back(term); // add to heap pointers vector
+                primeTerms.push_back(term);
+                break;
+            }
+
+            offset = (offset - it->second) & it->second;
+        } while (offset != 0);
+    }
+}
@@ -0,0 +1,93 @@
+#include "../include/support.h"
+
+namespace {
+    // LOW_HALVES[j] has the bits whose index has bit j cleared
+    const uint64_t LOW_HALVES[6] = {
+        0x5555555555555555ULL,
+        0x3333333333333333ULL,
+        0x0f0f0f0f0f0f0f0fULL,
+        0x00ff00ff00ff00ffULL,
+        0x0000ffff0000ffffULL,
+        0x00000000ffffffffULL
+    };
+
+    // the word holding the neighbours across variable j of the bits of
+    // words[w] (j below 6: the other half of the same word)
+    uint64_t neighbours(const std::vector<uint64_t>& words, size_t w, size_t j) {
+        if (j >= 6) {
+            return words[w ^ ((size_t)1 << (j - 6))];
+        }
+
+        size_t shift = (size_t)1 << j;
+        return ((words[w] & LOW_HALVES[j]) << shift) | ((words[w] >> shift) & LOW_HALVES[j]);
+    }
+}
+
+unsigned int drop_vacuous_variables(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count) {
+    const std::vector<uint64_t>& on = on_set.getWords();
+    const std::vector<uint64_t>& dont_care = dont_care_set.getWords();
+
+    unsigned int vacuous = 0;
+    for (size_t j = 0; j < literals_count && (size_t)__builtin_popcount(vacuous) + 1 < literals_count; ++j) {
+        // a minterm whose neighbour across the variable differs keeps it
+        uint64_t differences = 0;
+        for (size_t w = 0; w < on.size() && differences == 0; ++w) {
+            differences |= (neighbours(on, w, j) ^ on[w]) | (neighbours(dont_care, w, j) ^ dont_care[w]);
+        }
+
+        if (differences == 0) {
+            vacuous |= 1u << j;
+        }
+    }
+
+    return vacuous;
+}
+
+void reduced_values(const Bitmap& set, unsigned int vacuous, std::vector<unsigned int>& values) {
+    const std::vector<uint64_t>& words = set.getWords();
+    for (size_t w = 0; w < words.size(); ++w) {
+        for (uint64_t bits = words[w]; bits != 0; bits &= bits - 1) {
+            unsigned int minterm = w * 64 + __builtin_ctzll(bits);
+            if (minterm & vacuous) {
+                continue;
+            }
+
+            // pack the kept bits
+            unsigned int value = 0;
+            unsigned int position = 0;
+            for (unsigned int bit = 1; bit != 0 && bit <= minterm; bit <<= 1) {
+                if (vacuous & bit) {
+                    continue;
+                }
+
+                value |= (minterm & bit) ? (1u << position) : 0;
+                position++;
+            }
+
+            values.push_back(value);
+        }
+    }
+}
+
+Cube spread_cube(const Cube& cube, unsigned int vacuous, size_t literals_count) {
+    Cube spread(0, vacuous);
+    size_t position = 0;
+    for (size_t variable = 0; variable < literals_count; ++variable) {
+        unsigned int bit = 1u << variable;
+        if (vacuous & bit) {
+            continue;
+        }
+
+        if (cube.first & (1u << position)) {
+            spread.first |= bit;
+        }
+
+        if (cube.second & (1u << position)) {
+            spread.second |= bit;
+        }
+
+        position++;
+    }
+
+    return spread;
+}
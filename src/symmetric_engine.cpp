@@ -0,0 +1,276 @@
+#include "../include/symmetric_engine.h"
+#include "../include/cube_input.h"
+
+namespace {
+    double binomial(size_t n, size_t k) {
+        double result = 1;
+        for (size_t i = 1; i <= k; ++i) {
+            result = result * (n - k + i) / i;
+        }
+
+        return result;
+    }
+
+    // the subsets of mask with size bits, each joined to chosen
+    void subsets(unsigned int mask, size_t size, unsigned int chosen, std::vector<unsigned int>& result) {
+        if (size == 0) {
+            result.push_back(chosen);
+            return;
+        }
+
+        if ((size_t)__builtin_popcount(mask) < size) {
+            return;
+        }
+
+        unsigned int bit = mask & -mask;
+        subsets(mask ^ bit, size - 1, chosen | bit, result);
+        subsets(mask ^ bit, size, chosen, result);
+    }
+
+    // the lowest weight bits of block set, the rest cleared
+    unsigned int lowest_bits(unsigned int block, size_t weight) {
+        unsigned int bits = 0;
+        for (size_t i = 0; i < weight; ++i) {
+            unsigned int bit = block & -block;
+            bits |= bit;
+            block ^= bit;
+        }
+
+        return bits;
+    }
+}
+
+SymmetricFunction::SymmetricFunction(const Bitmap& on_set, const Bitmap& dont_care_set,
+                                     size_t literals_count) :
+    _literals_count(literals_count),
+    _blocks(),
+    _strides(),
+    _maximal_boxes(),
+    _primes_count(0)
+{
+    // each variable joins the first block it is symmetric with
+    for (unsigned int variable = 0; variable < literals_count; ++variable) {
+        bool joined = false;
+        for (std::vector<unsigned int>::iterator it = _blocks.begin(); it < _blocks.end(); ++it) {
+            unsigned int first = __builtin_ctz(*it);
+            if (isSymmetricPair(on_set, first, variable) && isSymmetricPair(dont_care_set, first, variable)) {
+                *it |= 1u << variable;
+                joined = true;
+                break;
+            }
+        }
+
+        if (!joined) {
+            _blocks.push_back(1u << variable);
+        }
+    }
+
+    // a box has a (lowest, highest) weight pair per block
+    size_t boxes_count = 1;
+    for (std::vector<unsigned int>::iterator it = _blocks.begin(); it < _blocks.end(); ++it) {
+        size_t radix = (__builtin_popcount(*it) + 1) * (__builtin_popcount(*it) + 1);
+        if (boxes_count > SYMMETRIC_MAX_BOXES / radix) {
+            _strides.clear();
+            return;
+        }
+
+        _strides.push_back(boxes_count);
+        boxes_count *= radix;
+    }
+
+    // the grid points, at the representative minterms of their weights
+    std::vector<char> care(1, false);
+    std::vector<char> on(1, false);
+    {
+        std::vector<unsigned int> minterms(1, 0);
+        for (std::vector<unsigned int>::iterator it = _blocks.begin(); it < _blocks.end(); ++it) {
+            size_t points_count = minterms.size();
+            for (size_t weight = 1; weight <= (size_t)__builtin_popcount(*it); ++weight) {
+                for (size_t point = 0; point < points_count; ++point) {
+                    minterms.push_back(minterms[point] | lowest_bits(*it, weight));
+                }
+            }
+        }
+
+        care.resize(minterms.size());
+        on.resize(minterms.size());
+        for (size_t point = 0; point < minterms.size(); ++point) {
+            on[point] = on_set.test(minterms[point]);
+            care[point] = on[point] || dont_care_set.test(minterms[point]);
+        }
+    }
+
+    std::vector<char> contained(boxes_count, 0);
+    std::vector<char> touching(boxes_count, 0);
+    for (size_t box = 0; box < boxes_count; ++box) {
+        bool valid = true;
+        for (size_t i = 0; i < _blocks.size() && valid; ++i) {
+            size_t size = __builtin_popcount(_blocks[i]);
+            size_t weights = (box / _strides[i]) % ((size + 1) * (size + 1));
+            valid = weights / (size + 1) <= weights % (size + 1);
+        }
+
+        if (!valid || !evaluate(box, contained, care, true) || !evaluate(box, touching, on, false)) {
+            continue;
+        }
+
+        // maximal: no side can be pushed out by one
+        bool maximal = true;
+        double primes_count = 1;
+        for (size_t i = 0; i < _blocks.size() && maximal; ++i) {
+            size_t size = __builtin_popcount(_blocks[i]);
+            size_t weights = (box / _strides[i]) % ((size + 1) * (size + 1));
+            size_t lowest = weights / (size + 1);
+            size_t highest = weights % (size + 1);
+            maximal = (lowest == 0 || !evaluate(box - (size + 1) * _strides[i], contained, care, true)) &&
+                      (highest == size || !evaluate(box + _strides[i], contained, care, true));
+            primes_count *= binomial(size, lowest) * binomial(size - lowest, size - highest);
+        }
+
+        if (maximal) {
+            _maximal_boxes.push_back(box);
+            _primes_count += primes_count;
+        }
+    }
+}
+
+SymmetricFunction::~SymmetricFunction() {
+}
+
+const std::vector<unsigned int>& SymmetricFunction::getBlocks() const {
+    return _blocks;
+}
+
+bool SymmetricFunction::isSymmetric() const {
+    return _blocks.size() < _literals_count;
+}
+
+bool SymmetricFunction::isTractable() const {
+    return !_strides.empty();
+}
+
+double SymmetricFunction::getPrimesCount() const {
+    return _primes_count;
+}
+
+void SymmetricFunction::generate(Terms& terms, Terms& primeTerms) const {
+    unsigned int all = (_literals_count == 32) ? ~0u : ((1u << _literals_count) - 1);
+    std::vector< std::vector<Cube> > choices(_blocks.size());
+    std::vector<size_t> digits(_blocks.size());
+    std::vector<unsigned int> positives;
+    std::vector<unsigned int> negatives;
+    for (std::vector<size_t>::const_iterator box = _maximal_boxes.begin(); box < _maximal_boxes.end(); ++box) {
+        // a block's literals: its positive ones as the value, all as the mask
+        for (size_t i = 0; i < _blocks.size(); ++i) {
+            size_t size = __builtin_popcount(_blocks[i]);
+            size_t weights = (*box / _strides[i]) % ((size + 1) * (size + 1));
+            positives.clear();
+            subsets(_blocks[i], weights / (size + 1), 0, positives);
+
+            choices[i].clear();
+            for (std::vector<unsigned int>::iterator positive = positives.begin();
+                 positive < positives.end(); ++positive)
+            {
+                negatives.clear();
+                subsets(_blocks[i] & ~*positive, size - weights % (size + 1), 0, negatives);
+                for (std::vector<unsigned int>::iterator negative = negatives.begin();
+                     negative < negatives.end(); ++negative)
+                {
+                    choices[i].push_back(Cube(*positive, *positive | *negative));
+                }
+            }
+        }
+
+        // one prime per combination of the blocks' choices
+        digits.assign(_blocks.size(), 0);
+        size_t i = 0;
+        do {
+            unsigned int value = 0;
+            unsigned int literals = 0;
+            for (size_t block = 0; block < _blocks.size(); ++block) {
+                value |= choices[block][digits[block]].first;
+                literals |= choices[block][digits[block]].second;
+            }
+
+            Term* term = new Term(value, all & ~literals, _literals_count);
+            terms.push_back(term); // add to heap pointers vector
+            primeTerms.push_back(term);
+
+            for (i = 0; i < _blocks.size() && ++digits[i] == choices[i].size(); ++i) {
+                digits[i] = 0;
+            }
+        } while (i < _blocks.size());
+    }
+}
+
+void SymmetricFunction::print(std::ostream& output) const {
+    for (std::vector<unsigned int>::const_iterator it = _blocks.begin(); it < _blocks.end(); ++it) {
+        output << (it == _blocks.begin() ? "{" : " {");
+        for (size_t i = 0; i < _literals_count; ++i) {
+            if (*it & (1u << (_literals_count - 1 - i))) {
+                output << (char)(i + 'a');
+            }
+        }
+
+        output << "}";
+    }
+}
+
+/**
+ * Swapping the two variables maps set onto itself: a member with them
+ * different has its swapped minterm in set too.
+ */
+bool SymmetricFunction::isSymmetricPair(const Bitmap& set, unsigned int first, unsigned int second) const {
+    unsigned int swap = (1u << first) | (1u << second);
+    const std::vector<uint64_t>& words = set.getWords();
+    for (size_t word = 0; word < words.size(); ++word) {
+        for (uint64_t bits = words[word]; bits != 0; bits &= bits - 1) {
+            unsigned int minterm = word * 64 + __builtin_ctzll(bits);
+            unsigned int mixed = minterm & swap;
+            if (mixed != 0 && mixed != swap && !set.test(minterm ^ swap)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Whether every (or some) point of the box is set in points, memoized: a
+ * box wider than one weight in a block is the union of the box without its
+ * highest weight there and the box without its lowest one.
+ */
+bool SymmetricFunction::evaluate(size_t box, std::vector<char>& memo, const std::vector<char>& points,
+                                 bool every) const
+{
+    if (memo[box] != 0) {
+        return memo[box] == 2;
+    }
+
+    bool result = false;
+    size_t point = 0;
+    size_t point_stride = 1;
+    size_t i = 0;
+    for (; i < _blocks.size(); ++i) {
+        size_t size = __builtin_popcount(_blocks[i]);
+        size_t weights = (box / _strides[i]) % ((size + 1) * (size + 1));
+        size_t lowest = weights / (size + 1);
+        if (lowest < weights % (size + 1)) {
+            bool first = evaluate(box - _strides[i], memo, points, every);
+            result = (every ? first : !first) ? evaluate(box + (size + 1) * _strides[i], memo, points, every)
+                                               : first;
+            break;
+        }
+
+        point += lowest * point_stride;
+        point_stride *= size + 1;
+    }
+
+    if (i == _blocks.size()) {
+        result = points[point];
+    }
+
+    memo[box] = result ? 2 : 1;
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "../include/term.h"
+#include "../include/memory_budget.h"
 
 #include <algorithm>
 #include <cmath>
@@ -12,9 +13,32 @@ Term::Term(unsigned int num, size_t literals_count) :
     _selected(false),
     _prime_implicant(false),
     _dont_care(false),
-    _literals_count(literals_count)
+    _literals_count(literals_count),
+    _charged_bytes(0)
 {
     _minterms.push_back(num);
+    charge();
+}
+
+Term::Term(unsigned int num, unsigned int dash_mask, size_t literals_count) : 
+    Binary(num & ~dash_mask), 
+    _dashes(), 
+    _minterms(),
+    _remaining_minterms(),
+    _selected(false),
+    _prime_implicant(false),
+    _dont_care(false),
+    _literals_count(literals_count),
+    _charged_bytes(0)
+{
+    for (size_t i = 0; i < literals_count; ++i) {
+        if (dash_mask & (1u << i)) {
+            _dashes.push_back(i + 1);
+        }
+    }
+
+    // the minterms of a cube are only enumerated when first asked for
+    charge();
 }
 
 Term::Term(Term& first, Term& second, size_t new_dash) : 
@@ -25,7 +49,8 @@ Term::Term(Term& first, Term& second, size_t new_dash) :
     _selected(false),
     _prime_implicant(false),
     _dont_care(first.isDontCare() && second.isDontCare()),
-    _literals_count(std::max(first.getLiteralCount(), second.getLiteralCount()))
+    _literals_count(std::max(first.getLiteralCount(), second.getLiteralCount())),
+    _charged_bytes(0)
 {
     for (std::vector<size_t>::iterator it = first.getMinterms().begin();
          it < first.getMinterms().end(); ++it)
@@ -52,9 +77,60 @@ Term::Term(Term& first, Term& second, size_t new_dash) :
     }
 
     _dashes.push_back(new_dash);
+    charge();
+}
+
+Term::~Term() { 
+    MemoryBudget::instance().release(_charged_bytes);
+}
+
+void* Term::operator new(size_t size) {
+    MemoryBudget& budget = MemoryBudget::instance();
+    budget.allocate(size);
+    try {
+        budget.addImplicant();
+    } catch (...) {
+        budget.release(size);
+        throw;
+    }
+
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        budget.removeImplicant();
+        budget.release(size);
+        throw;
+    }
+}
+
+void Term::operator delete(void* pointer, size_t size) {
+    if (pointer == 0) {
+        return;
+    }
+
+    MemoryBudget& budget = MemoryBudget::instance();
+    budget.release(size);
+    budget.removeImplicant();
+    ::operator delete(pointer);
+}
+
+void Term::charge() {
+    // charge the heap memory held by the minterms and dashes lists
+    size_t bytes = (_minterms.capacity() + _dashes.capacity()) * sizeof(size_t);
+    MemoryBudget::instance().allocate(bytes - _charged_bytes);
+    _charged_bytes = bytes;
 }
 
-Term::~Term() { }
+void Term::enumerateMinterms(std::vector<size_t>& minterms) const {
+    // count over the dash bits to get every minterm of the cube
+    unsigned int dash_mask = getDashMask();
+    unsigned int value = _num & ~dash_mask;
+    unsigned int subset = 0;
+    do {
+        minterms.push_back(value | subset);
+        subset = (subset - dash_mask) & dash_mask;
+    } while (subset != 0);
+}
 
 std::string Term::getExpression() const {
     std::string expression = getBinary();
@@ -119,7 +195,10 @@ char Term::charAt(size_t i) const {
 
 int Term::separatingBit(const Term& other) const {
     int separating_bit = -1;
-    int max_num = std::max(_num, other.getDecimal());
+
+    // merged terms carry their dashes as ones, cubes (and restored
+    // implicants) do not: the dashes must be compared all the same
+    int max_num = std::max(_num | getDashMask(), other.getDecimal() | other.getDashMask());
     for (size_t i = 0; max_num > 0; ++i) {
         if (charAt(i) != other.charAt(i)) {
             if (separating_bit != -1) {
@@ -139,6 +218,11 @@ int Term::separatingBit(const Term& other) const {
 }
 
 std::vector<size_t>& Term::getMinterms() {
+    if (_minterms.empty()) {
+        enumerateMinterms(_minterms);
+        charge();
+    }
+
     return _minterms;
 }
 
@@ -146,14 +230,30 @@ std::vector<size_t>& Term::getDashes() {
     return _dashes;
 }
 
+unsigned int Term::getDashMask() const {
+    unsigned int dash_mask = 0;
+    for (std::vector<size_t>::const_iterator it = _dashes.begin();
+         it < _dashes.end(); ++it)
+    {
+        dash_mask |= 1u << (*it - 1);
+    }
+
+    return dash_mask;
+}
+
 std::string Term::getDecimals() const {
+    std::vector<size_t> minterms(_minterms);
+    if (minterms.empty()) {
+        enumerateMinterms(minterms);
+    }
+
     std::stringstream decimals;
-    if (_minterms.size() > 0) {
-        decimals << _minterms.at(0);
+    if (minterms.size() > 0) {
+        decimals << minterms.at(0);
     }
 
-    for (std::vector<size_t>::const_iterator it = _minterms.begin()+1;
-         it < _minterms.end(); ++it)
+    for (std::vector<size_t>::const_iterator it = minterms.begin()+1;
+         it < minterms.end(); ++it)
     {
         decimals << "," << *it;
     }
@@ -209,13 +309,17 @@ void Term::coverMinterm(size_t i) {
 }
 
 void Term::primeImplicantCandidate() {
-    _remaining_minterms = _minterms;   
+    _remaining_minterms = getMinterms();   
 }
 
 std::vector<size_t> Term::getRemainingMinterms() const {
     return _remaining_minterms;
 }
 
+size_t Term::getRemainingMintermsCount() const {
+    return _remaining_minterms.size();
+}
+
 std::ostream& operator<<(std::ostream &strm, const Term& term) {
     return strm << term.getLiterals();
 }
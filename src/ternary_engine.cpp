@@ -0,0 +1,177 @@
+#include "../include/ternary_engine.h"
+
+namespace {
+    // LOW_HALVES[j] has the bits whose index has bit j cleared
+    const uint64_t LOW_HALVES[6] = {
+        0x5555555555555555ULL,
+        0x3333333333333333ULL,
+        0x0f0f0f0f0f0f0f0fULL,
+        0x00ff00ff00ff00ffULL,
+        0x0000ffff0000ffffULL,
+        0x00000000ffffffffULL
+    };
+
+    // packs the bits of x at indices with bit j cleared into the low 32 bits
+    uint64_t compress(uint64_t x, size_t j) {
+        x &= LOW_HALVES[j];
+        for (size_t t = j; t < 5; ++t) {
+            x = (x | (x >> (1u << t))) & LOW_HALVES[t + 1];
+        }
+
+        return x;
+    }
+
+    /**
+     * Depth first walk over the dash masks, each mask reached from the one
+     * without its highest dash. Only the bitmaps on the current path are
+     * alive, and a mask whose bitmap is empty has no implicant below it.
+     */
+    class TernarySearch {
+        public:
+            TernarySearch(size_t literals_count, Terms& terms, Terms& primeTerms) :
+                _literals_count(literals_count),
+                _terms(terms),
+                _prime_terms(primeTerms)
+            {
+            }
+
+            // implicants: cubes inside ON + Dont-Care, on_cover: cubes
+            // holding at least one ON minterm, both indexed by the free bits
+            void visit(const std::vector<uint64_t>& implicants,
+                       const std::vector<uint64_t>& on_cover,
+                       unsigned int dash_mask, size_t dashes, size_t next_variable)
+            {
+                size_t free_count = _literals_count - dashes;
+                addPrimes(implicants, on_cover, dash_mask, free_count);
+
+                std::vector<uint64_t> merged_implicants;
+                std::vector<uint64_t> merged_on_cover;
+                for (size_t variable = next_variable; variable < _literals_count; ++variable) {
+                    // every dash is below variable, so its free bit index is
+                    size_t position = variable - dashes;
+
+                    if (!fold(implicants, free_count, position, true, merged_implicants)) {
+                        continue;
+                    }
+
+                    fold(on_cover, free_count, position, false, merged_on_cover);
+                    visit(merged_implicants, merged_on_cover,
+                          dash_mask | (1u << variable), dashes + 1, variable + 1);
+                }
+            }
+
+        private:
+            TernarySearch(const TernarySearch&);
+
+            TernarySearch& operator=(const TernarySearch&);
+
+            // merges the two halves along free bit position, returning
+            // whether any bit is left set
+            static bool fold(const std::vector<uint64_t>& source, size_t free_count,
+                             size_t position, bool conjunction, std::vector<uint64_t>& output)
+            {
+                size_t output_words = ((1u << (free_count - 1)) + 63) / 64;
+                output.assign(output_words, 0);
+
+                uint64_t any = 0;
+                if (position >= 6) {
+                    // halves are whole runs of words
+                    size_t run = (size_t)1 << (position - 6);
+                    for (size_t w = 0; w < output_words; ++w) {
+                        size_t low = (w / run) * 2 * run + w % run;
+                        output[w] = conjunction ? (source[low] & source[low + run])
+                                                : (source[low] | source[low + run]);
+                        any |= output[w];
+                    }
+
+                    return any != 0;
+                }
+
+                size_t shift = (size_t)1 << position;
+                for (size_t w = 0; w < output_words; ++w) {
+                    uint64_t halves[2] = { 0, 0 };
+                    for (size_t i = 0; i < 2 && 2 * w + i < source.size(); ++i) {
+                        uint64_t x = source[2 * w + i];
+                        halves[i] = compress(conjunction ? (x & (x >> shift)) : (x | (x >> shift)),
+                                             position);
+                    }
+
+                    output[w] = halves[0] | (halves[1] << 32);
+                    any |= output[w];
+                }
+
+                return any != 0;
+            }
+
+            void addPrimes(const std::vector<uint64_t>& implicants,
+                           const std::vector<uint64_t>& on_cover,
+                           unsigned int dash_mask, size_t free_count)
+            {
+                // an implicant with an implicant neighbour along some free
+                // bit is contained in their merge, so it is not prime
+                std::vector<uint64_t> expandable(implicants.size(), 0);
+                for (size_t position = 0; position < free_count; ++position) {
+                    if (position >= 6) {
+                        size_t run = (size_t)1 << (position - 6);
+                        for (size_t w = 0; w < implicants.size(); ++w) {
+                            expandable[w] |= implicants[w ^ run];
+                        }
+                    } else {
+                        size_t shift = (size_t)1 << position;
+                        for (size_t w = 0; w < implicants.size(); ++w) {
+                            uint64_t x = implicants[w];
+                            expandable[w] |= ((x & LOW_HALVES[position]) << shift) |
+                                             ((x >> shift) & LOW_HALVES[position]);
+                        }
+                    }
+                }
+
+                for (size_t w = 0; w < implicants.size(); ++w) {
+                    uint64_t primes = implicants[w] & ~expandable[w] & on_cover[w];
+                    for (; primes != 0; primes &= primes - 1) {
+                        size_t index = w * 64 + __builtin_ctzll(primes);
+                        Term* term = new Term(deposit(index, dash_mask), dash_mask, _literals_count);
+                        _terms.push_back(term); // add to heap pointers vector
+                        _prime_terms.push_back(term);
+                    }
+                }
+            }
+
+            // spreads the free bits index over the bits outside dash_mask
+            unsigned int deposit(size_t index, unsigned int dash_mask) const {
+                unsigned int value = 0;
+                for (size_t bit = 0; bit < _literals_count; ++bit) {
+                    if (dash_mask & (1u << bit)) {
+                        continue;
+                    }
+
+                    if (index & 1) {
+                        value |= 1u << bit;
+                    }
+
+                    index >>= 1;
+                }
+
+                return value;
+            }
+
+            size_t _literals_count;
+            Terms& _terms;
+            Terms& _prime_terms;
+    };
+}
+
+void ternary_terms(const Bitmap& on_set, const Bitmap& dont_care_set, size_t literals_count,
+                   Terms& terms, Terms& primeTerms)
+{
+    const std::vector<uint64_t>& on_words = on_set.getWords();
+    const std::vector<uint64_t>& dont_care_words = dont_care_set.getWords();
+
+    std::vector<uint64_t> implicants(on_words.size());
+    for (size_t w = 0; w < on_words.size(); ++w) {
+        implicants[w] = on_words[w] | dont_care_words[w];
+    }
+
+    TernarySearch search(literals_count, terms, primeTerms);
+    search.visit(implicants, on_words, 0, 0, 0);
+}
@@ -0,0 +1,99 @@
+#include "../include/zdd_engine.h"
+#include "../include/decision_diagram.h"
+
+#include <algorithm>
+
+namespace {
+    typedef std::pair<unsigned int, unsigned int> Cube;
+
+    struct CountCompare {
+        CountCompare(const std::vector<double>& counts) : _counts(counts) {
+        }
+
+        bool operator()(size_t left, size_t right) const {
+            return _counts[left] < _counts[right];
+        }
+
+        const std::vector<double>& _counts;
+    };
+}
+
+Terms zdd_minimize(const std::vector<unsigned int>& onValues,
+                   const std::vector<unsigned int>& dontCareValues,
+                   size_t literals_count,
+                   double& primes_count)
+{
+    DecisionDiagram diagram(literals_count);
+
+    std::vector<unsigned int> care(onValues);
+    care.insert(care.end(), dontCareValues.begin(), dontCareValues.end());
+
+    DecisionDiagram::Node function = diagram.bddFromMinterms(care);
+    DecisionDiagram::Node primes = diagram.primes(function);
+    primes_count = diagram.zddCount(primes);
+
+    // ON minterms that actually need covering, sorted for lookups
+    std::vector<unsigned int> dont_cares(dontCareValues);
+    std::sort(dont_cares.begin(), dont_cares.end());
+
+    std::vector<unsigned int> on;
+    for (std::vector<unsigned int>::const_iterator it = onValues.begin();
+         it < onValues.end(); ++it)
+    {
+        if (!std::binary_search(dont_cares.begin(), dont_cares.end(), *it)) {
+            on.push_back(*it);
+        }
+    }
+
+    std::sort(on.begin(), on.end());
+    on.erase(std::unique(on.begin(), on.end()), on.end());
+
+    // the ON minterms left to cover, as a BDD
+    DecisionDiagram::Node uncovered = diagram.bddFromMinterms(on);
+    std::vector<Cube> selected;
+    std::vector<double> counts(on.size(), 0);
+
+    // essential primes: minterms contained in exactly one prime
+    for (size_t i = 0; i < on.size(); ++i) {
+        DecisionDiagram::Node candidates = diagram.zddContaining(primes, on[i]);
+        counts[i] = diagram.zddCount(candidates);
+        if (counts[i] != 1 || !diagram.bddContains(uncovered, on[i])) {
+            continue;
+        }
+
+        std::vector<Cube> cubes;
+        diagram.zddCubes(candidates, cubes);
+        selected.push_back(cubes.at(0));
+        uncovered = diagram.bddWithoutCube(uncovered, cubes.at(0).first, cubes.at(0).second);
+    }
+
+    // cyclic core: the minterms left uncovered by the essentials, hardest
+    // (fewest candidate primes) first, each covered by the candidate that
+    // covers the most, picked on the diagrams
+    std::vector<size_t> order;
+    for (size_t i = 0; i < on.size(); ++i) {
+        if (diagram.bddContains(uncovered, on[i])) {
+            order.push_back(i);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), CountCompare(counts));
+
+    for (std::vector<size_t>::iterator it = order.begin(); it < order.end(); ++it) {
+        if (!diagram.bddContains(uncovered, on[*it])) {
+            continue;
+        }
+
+        Cube best;
+        diagram.zddBestCube(diagram.zddContaining(primes, on[*it]), uncovered, best);
+        selected.push_back(best);
+        uncovered = diagram.bddWithoutCube(uncovered, best.first, best.second);
+    }
+
+    Terms cover;
+    for (std::vector<Cube>::iterator it = selected.begin(); it < selected.end(); ++it) {
+        cover.push_back(new Term(it->first, it->second, literals_count));
+    }
+
+    return cover;
+}
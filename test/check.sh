@@ -0,0 +1,117 @@
+#!/bin/sh
+# Regression checks for qmc, run by `make check` from the repository root.
+# Each check runs bin/qmc on a fixed function and compares the cover, the
+# --verify verdict or the exit status with the known answer. QMC selects
+# another binary.
+
+QMC=${QMC:-bin/qmc}
+failures=0
+count=0
+
+fail() {
+    echo "FAIL: $1"
+    failures=$((failures + 1))
+}
+
+# expect COVER ARGS...: the first output line is COVER
+expect() {
+    expected="$1"
+    shift
+    count=$((count + 1))
+    actual=$($QMC "$@" 2>/dev/null | head -n 1)
+    if [ "$actual" != "$expected" ]; then
+        fail "qmc $* printed '$actual', expected '$expected'"
+    fi
+}
+
+# verify ARGS...: --verify accepts the cover
+verify() {
+    count=$((count + 1))
+    if ! $QMC "$@" --verify 2>&1 >/dev/null | grep -q "^verify: ok"; then
+        fail "qmc $* --verify did not report ok"
+    fi
+}
+
+# cost PRODUCTS ARGS...: the cover has PRODUCTS products and passes --verify
+cost() {
+    expected="$1"
+    shift
+    count=$((count + 1))
+    products=$($QMC "$@" 2>/dev/null | head -n 1 | tr -cd '+' | wc -c)
+    if [ "$((products + 1))" != "$expected" ]; then
+        fail "qmc $* printed $((products + 1)) products, expected $expected"
+    fi
+    verify "$@"
+}
+
+# session INPUT EXPECTED ARGS...: --session prints EXPECTED for the edits in INPUT
+session() {
+    input="$1"
+    expected="$2"
+    shift 2
+    count=$((count + 1))
+    actual=$(printf "$input" | $QMC "$@" --session 2>/dev/null)
+    if [ "$actual" != "$expected" ]; then
+        fail "qmc $* --session printed '$actual', expected '$expected'"
+    fi
+}
+
+# status CODE ARGS...: qmc exits with CODE
+status() {
+    expected="$1"
+    shift
+    count=$((count + 1))
+    $QMC "$@" >/dev/null 2>&1
+    actual=$?
+    if [ "$actual" != "$expected" ]; then
+        fail "qmc $* exited with $actual, expected $expected"
+    fi
+}
+
+# support reduction never fills in Dont-Cares
+expect "f = c'" -l 3 --sop 0 2 4 --dont-care 1 3 5 6
+expect "f = c'" -l 3 --sop 0 2 4 --dont-care 1 3 5 6 --full-support
+expect "f = b'd'" -l 4 --sop 0 2 8 10
+verify -l 3 --sop 0 2 4 --dont-care 1 3 5 6
+
+# the cover table's covers are minimal (the costs were proven by the search)
+cost 3 -l 3 --sop 0 1 2 5 6 7
+cost 3 -l 4 --sop 2 3 13 14 --dont-care 7
+cost 3 -l 4 --sop 0 2 4 6 7 8 11 12 --dont-care 3 14 15
+cost 4 -l 4 --sop 1 2 3 4 6 8 9 11 13 --dont-care 0 7 15
+expect "f = c' + a'b' + bd' + ad" -l 4 --sop 0 1 2 3 4 5 6 8 9 11 12 13 14 15 --deadline 50 --engine tabular
+cost 4 -l 4 --sop 0 1 2 3 4 5 6 8 9 11 12 13 14 15 --deadline 50 --engine tabular
+
+# every engine's cover passes --verify
+for engine in tabular zdd consensus pipelined ternary shannon symmetric heuristic; do
+    verify -l 6 --sop 1 3 5 7 9 22 23 40 41 48-63 --dont-care 0 10 11 --engine $engine
+done
+
+# the symmetric engine: majority of 5 is the C(5, 3) products of 3 literals
+cost 10 -l 5 --sop 7 11 13 14 15 19 21 22 23 25 26 27 28 29 30 31 --engine symmetric
+expect "f = abe + abd + abc + cde + bde + bce + bcd + ade + ace + acd" \
+    -l 5 --sop 7 11 13 14 15 19 21 22 23 25 26 27 28 29 30 31
+
+# --off builds the primes as hitting sets
+expect "f = n + d" -l 16 --sop 7 4096 --off 0 1 2 3
+verify -l 16 --sop 7 4096 --off 0 1 2 3
+cost 2 -l 4 --sop 0 5 --off 1 4
+
+# --session repairs the cover edit by edit
+session 'remove 14\ndc 3\n' "f = b'c' + cd' + a'bd
+f = b'c' + b'd' + a'bd + a'bc
+f = b'c' + b'd' + a'd + a'c" -l 4 --sop 0 1 2 5 6 7 8 9 10 14
+
+# a budget exceeded in the cover phase aborts or falls back, never crashes
+status 2 --cubes=1-----,-11---,--11--,---11-,----11,0----0 --dc-cubes=1-1-1- --engine consensus \
+    --max-memory 2K --full-support
+verify --cubes=1-----,-11---,--11--,---11-,----11,0----0 --dc-cubes=1-1-1- --engine consensus \
+    --max-memory 2K --full-support --budget-fallback heuristic
+
+# --deadline needs a prime chart, --portfolio a deadline
+status 1 -l 4 --sop 1 3 5 7 --engine zdd --deadline 100
+status 1 -l 4 --sop 1 3 5 7 --engine heuristic --deadline 100
+status 1 -l 4 --sop 1 3 5 7 --portfolio --threads 4
+
+echo "$((count - failures)) of $count checks passed"
+[ "$failures" -eq 0 ]